@@ -0,0 +1,573 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+/**
+ * Description of the build, recorded with the results; set by the build system.
+ */
+#if !defined(BENCH_BUILD)
+#	define BENCH_BUILD "unknown build"
+#endif
+
+/**
+ * Minimal benchmark harness for the containers: wall-clock time per operation, plus hardware
+ * counters per operation where the kernel allows them.
+ */
+namespace bench {
+
+/**
+ * Keep the compiler from optimizing away a value, or the computation of it.
+ */
+template <typename Tp>
+inline void do_not_optimize(const Tp& v)
+{
+	asm volatile("" : : "r,m"(v) : "memory");
+}
+
+/**
+ * Get the model name of the CPU, recorded with the results.
+ */
+inline std::string cpu_model()
+{
+	std::ifstream is("/proc/cpuinfo");
+	std::string line;
+	while(std::getline(is, line)) {
+		const std::size_t colon = line.find(':');
+		if(line.compare(0, 10, "model name") != 0 || colon == std::string::npos)
+			continue;
+		const std::size_t start = line.find_first_not_of(" \t", colon + 1);
+		return start == std::string::npos ? std::string() : line.substr(start);
+	}
+	return "unknown CPU";
+}
+
+/**
+ * Hardware counters of the calling thread, in user space, through `perf_event_open`.
+ *
+ * Each counter is opened on its own, so a missing one (no LLC event in a VM, for example) does
+ * not take the others down. When none can be opened, because of `perf_event_paranoid`, a
+ * seccomp filter or a non-Linux system, available() is false and all counters read as -1.
+ */
+class perf_counters {
+public:
+	enum counter { cycles, instructions, l1d_misses, llc_misses, branch_misses, count };
+
+	static constexpr const char* names[count] = {
+		"cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses",
+	};
+
+	perf_counters()
+	{
+		m_fds.fill(-1);
+#if defined(__linux__)
+		const std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D
+						    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+						    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		open(cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		open(instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		open(l1d_misses, PERF_TYPE_HW_CACHE, l1d_read_miss);
+		open(llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+		open(branch_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+	}
+
+	~perf_counters()
+	{
+#if defined(__linux__)
+		for(int fd : m_fds)
+			if(fd >= 0)
+				close(fd);
+#endif
+	}
+
+	perf_counters(const perf_counters&) = delete;
+	perf_counters& operator=(const perf_counters&) = delete;
+
+	bool available() const noexcept
+	{
+		return std::any_of(m_fds.begin(), m_fds.end(), [](int fd) { return fd >= 0; });
+	}
+
+	bool available(counter c) const noexcept
+	{
+		return m_fds[c] >= 0;
+	}
+
+	void start()
+	{
+#if defined(__linux__)
+		for(int fd : m_fds) {
+			if(fd >= 0) {
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+
+	/**
+	 * Stop counting until resume(), keeping the counts.
+	 */
+	void pause()
+	{
+#if defined(__linux__)
+		for(int fd : m_fds)
+			if(fd >= 0)
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+	}
+
+	void resume()
+	{
+#if defined(__linux__)
+		for(int fd : m_fds)
+			if(fd >= 0)
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	/**
+	 * Stop counting, and get the counts since start(), scaled up when the kernel had to
+	 * multiplex the counters. Unavailable counters read as -1.
+	 */
+	std::array<double, count> stop()
+	{
+		std::array<double, count> out;
+		out.fill(-1);
+#if defined(__linux__)
+		for(int fd : m_fds)
+			if(fd >= 0)
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		for(std::size_t c = 0; c < count; c++) {
+			std::uint64_t v[3]; // Value, time enabled, time running
+			if(m_fds[c] < 0 || ::read(m_fds[c], v, sizeof(v)) != sizeof(v))
+				continue;
+			// Scale by time enabled over time running
+			const double enabled = static_cast<double>(v[1]);
+			const double running = static_cast<double>(v[2]);
+			out[c] = running > 0 ? static_cast<double>(v[0]) * enabled / running : 0;
+		}
+#endif
+		return out;
+	}
+
+protected:
+#if defined(__linux__)
+	void open(counter c, std::uint32_t type, std::uint64_t config)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		m_fds[c] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+#endif
+
+	std::array<int, count> m_fds;
+};
+
+/**
+ * Result of one benchmark: the median of the repetitions, per operation.
+ */
+struct result {
+	std::string name;
+	std::size_t element_size; // Shape of the container, or 0 when not given
+	std::size_t capacity;
+	std::uint64_t ops; // Operations per repetition
+	double ns;	   // Nanoseconds per operation
+	double ns_min;	   // Same, for the fastest repetition
+	std::array<double, perf_counters::count> counters; // Per operation, or -1
+};
+
+struct options {
+	const char* filter = nullptr; // Only run benchmarks whose name contains this
+	bool csv = false;
+	bool counters = true;
+	bool sweep = false; // Run the capacity sweep instead of the default benchmarks
+	double min_time = 0.05; // Seconds per repetition
+	int repetitions = 5;
+	const char* baseline = nullptr; // CSV output of an earlier run to compare against
+	double threshold = 10;		// Slowdown over the baseline that fails, in percent
+	int attempts = 1;		// Runs that must all be slower than the baseline to fail
+	const char* output = nullptr;	// Write the results to this file instead of stdout
+
+	/**
+	 * Parse `--filter=S`, `--csv`, `--no-counters`, `--sweep`, `--min-time=SECONDS`,
+	 * `--repetitions=N`, `--baseline=FILE`, `--threshold=PERCENT`, `--attempts=N` and
+	 * `--output=FILE`.
+	 */
+	static options parse(int argc, char** argv)
+	{
+		options o;
+		for(int i = 1; i < argc; i++) {
+			const char* a = argv[i];
+			if(std::strncmp(a, "--filter=", 9) == 0)
+				o.filter = a + 9;
+			else if(std::strcmp(a, "--csv") == 0)
+				o.csv = true;
+			else if(std::strcmp(a, "--no-counters") == 0)
+				o.counters = false;
+			else if(std::strcmp(a, "--sweep") == 0)
+				o.sweep = true;
+			else if(std::strncmp(a, "--min-time=", 11) == 0)
+				o.min_time = std::atof(a + 11);
+			else if(std::strncmp(a, "--repetitions=", 14) == 0)
+				o.repetitions = std::max(1, std::atoi(a + 14));
+			else if(std::strncmp(a, "--baseline=", 11) == 0)
+				o.baseline = a + 11;
+			else if(std::strncmp(a, "--threshold=", 12) == 0)
+				o.threshold = std::atof(a + 12);
+			else if(std::strncmp(a, "--attempts=", 11) == 0)
+				o.attempts = std::max(1, std::atoi(a + 11));
+			else if(std::strncmp(a, "--output=", 9) == 0)
+				o.output = a + 9;
+			else
+				std::fprintf(stderr, "Ignoring unknown option %s\n", a);
+		}
+		return o;
+	}
+};
+
+/**
+ * Runs benchmarks and prints their results as they complete.
+ */
+class runner {
+public:
+	explicit runner(const options& o)
+		: m_options(o)
+		, m_element_size(0)
+		, m_capacity(0)
+		, m_out(stdout)
+	{
+		if(m_options.output && !(m_out = std::fopen(m_options.output, "w"))) {
+			std::fprintf(stderr, "Cannot write %s\n", m_options.output);
+			std::exit(1);
+		}
+		if(!m_options.counters)
+			return;
+		if(!m_counters.available())
+			std::fprintf(stderr, "Hardware counters unavailable (perf_event_paranoid?),"
+					     " reporting time only\n");
+	}
+
+	~runner()
+	{
+		if(m_out != stdout)
+			std::fclose(m_out);
+	}
+
+	runner(const runner&) = delete;
+	runner& operator=(const runner&) = delete;
+
+	const options& config() const noexcept
+	{
+		return m_options;
+	}
+
+	/**
+	 * Set the element size and capacity reported with the following benchmarks.
+	 */
+	void shape(std::size_t element_size, std::size_t capacity) noexcept
+	{
+		m_element_size = element_size;
+		m_capacity = capacity;
+	}
+
+	/**
+	 * Stop timing and counting within a benchmark, for setup that is not part of the
+	 * operations measured, until resume(). Each pause costs two clock reads, which are
+	 * partly timed, so keep the timed phases long compared to that. The counter calls
+	 * happen between the two clock reads, so their cost is not timed.
+	 */
+	void pause()
+	{
+		m_pause_start = std::chrono::steady_clock::now();
+		if(use_counters())
+			m_counters.pause();
+	}
+
+	void resume()
+	{
+		if(use_counters())
+			m_counters.resume();
+		m_paused += std::chrono::steady_clock::now() - m_pause_start;
+	}
+
+	/**
+	 * Benchmark `fn(iterations)`, which performs `ops_per_iteration` operations per
+	 * iteration. The iterations are scaled until a repetition takes at least `min_time`.
+	 */
+	template <typename Fn>
+	void run(const std::string& name, std::uint64_t ops_per_iteration, Fn&& fn)
+	{
+		if(m_options.filter && name.find(m_options.filter) == std::string::npos)
+			return;
+
+		std::uint64_t iterations = 1;
+		while(true) {
+			const double t = time(fn, iterations);
+			if(t >= m_options.min_time || iterations >= (std::uint64_t(1) << 40))
+				break;
+			// Aim a bit above min_time, growing at most 10x at once
+			const double scale = t > 0 ? m_options.min_time * 1.2 / t : 10;
+			const double grow = std::min(10.0, std::max(1.5, scale));
+			const double next = static_cast<double>(iterations) * grow;
+			iterations = static_cast<std::uint64_t>(next);
+		}
+
+		std::vector<double> times;
+		std::vector<std::array<double, perf_counters::count>> counts;
+		for(int r = 0; r < m_options.repetitions; r++) {
+			if(use_counters())
+				m_counters.start();
+			times.push_back(time(fn, iterations));
+			if(use_counters())
+				counts.push_back(m_counters.stop());
+		}
+
+		result res;
+		res.name = name;
+		res.element_size = m_element_size;
+		res.capacity = m_capacity;
+		res.ops = iterations * ops_per_iteration;
+		const double ops = static_cast<double>(res.ops);
+		res.ns = median(times) * 1e9 / ops;
+		res.ns_min = *std::min_element(times.begin(), times.end()) * 1e9 / ops;
+		res.counters.fill(-1);
+		for(std::size_t c = 0; c < perf_counters::count && !counts.empty(); c++) {
+			std::vector<double> v;
+			for(const auto& a : counts)
+				v.push_back(a[c]);
+			if(v[0] >= 0)
+				res.counters[c] = median(v) / ops;
+		}
+		print(res);
+		m_results.push_back(res);
+	}
+
+	const std::vector<result>& results() const noexcept
+	{
+		return m_results;
+	}
+
+	/**
+	 * Forget the results so far, to run the benchmarks again.
+	 */
+	void clear() noexcept
+	{
+		m_results.clear();
+	}
+
+	/**
+	 * Compare the results so far with the CSV output of an earlier run, and print the
+	 * change of each benchmark found in both.
+	 *
+	 * The fastest repetition of each is compared, as noise on a shared machine only ever
+	 * adds time. A benchmark regresses when it is slower than its baseline by more than
+	 * `threshold` percent.
+	 *
+	 * Times only compare on the same machine and build, so a baseline recorded on another
+	 * CPU or with another build gets a warning.
+	 *
+	 * @return Whether the baseline could be read and no benchmark regressed
+	 */
+	bool compare(const std::string& path) const
+	{
+		std::map<std::string, double> base;
+		std::map<std::string, std::string> about;
+		if(!read_baseline(path, base, about)) {
+			std::fprintf(stderr, "Cannot read baseline %s\n", path.c_str());
+			return false;
+		}
+		if(about["cpu"] != cpu_model() || about["build"] != BENCH_BUILD) {
+			std::fprintf(stderr, "Baseline recorded on %s, %s; this is %s, %s\n",
+				     about["cpu"].c_str(), about["build"].c_str(),
+				     cpu_model().c_str(), BENCH_BUILD);
+		}
+
+		std::printf("\n%-40s %10s %10s %8s\n", "against baseline", "was ns/op", "ns/op",
+			    "change");
+		bool passed = true;
+		std::size_t compared = 0;
+		for(const result& r : m_results) {
+			const auto it = base.find(r.name);
+			if(it == base.end())
+				continue;
+			const double change = (r.ns_min / it->second - 1) * 100;
+			const bool regressed = change > m_options.threshold;
+			std::printf("%-40s %10.3f %10.3f %+7.1f%%%s\n", r.name.c_str(), it->second,
+				    r.ns_min, change, regressed ? "  REGRESSED" : "");
+			passed = passed && !regressed;
+			compared++;
+		}
+		if(!compared) {
+			std::fprintf(stderr, "No benchmark found in baseline %s\n", path.c_str());
+			return false;
+		}
+		return passed;
+	}
+
+	static double median(std::vector<double> v)
+	{
+		std::sort(v.begin(), v.end());
+		const std::size_t n = v.size();
+		return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+	}
+
+protected:
+	bool use_counters() const noexcept
+	{
+		return m_options.counters && m_counters.available();
+	}
+
+	/**
+	 * Get the seconds `fn(iterations)` takes, without its pauses.
+	 */
+	template <typename Fn>
+	double time(Fn& fn, std::uint64_t iterations)
+	{
+		m_paused = std::chrono::steady_clock::duration::zero();
+		const auto t0 = std::chrono::steady_clock::now();
+		fn(iterations);
+		const std::chrono::duration<double> dt =
+			std::chrono::steady_clock::now() - t0 - m_paused;
+		return dt.count();
+	}
+
+	/**
+	 * Split a line of CSV, with fields optionally in double quotes.
+	 */
+	static std::vector<std::string> split_csv(const std::string& line)
+	{
+		std::vector<std::string> fields(1);
+		bool quoted = false;
+		for(char c : line) {
+			if(c == '"')
+				quoted = !quoted;
+			else if(c == ',' && !quoted)
+				fields.emplace_back();
+			else
+				fields.back() += c;
+		}
+		return fields;
+	}
+
+	/**
+	 * Read the fastest time per operation of each benchmark in a CSV file written with
+	 * `--csv`, and the `# key: value` lines that precede them.
+	 */
+	static bool read_baseline(const std::string& path, std::map<std::string, double>& out,
+				  std::map<std::string, std::string>& about)
+	{
+		std::ifstream is(path);
+		std::string line;
+		while(std::getline(is, line) && line.compare(0, 2, "# ") == 0) {
+			const std::size_t colon = line.find(": ");
+			if(colon != std::string::npos)
+				about[line.substr(2, colon - 2)] = line.substr(colon + 2);
+		}
+		if(!is)
+			return false;
+		const std::vector<std::string> header = split_csv(line);
+		const auto column = [&header](const char* name) {
+			const auto it = std::find(header.begin(), header.end(), name);
+			return static_cast<std::size_t>(it - header.begin());
+		};
+		const std::size_t name = column("name"), ns = column("ns_per_op_min");
+		if(name == header.size() || ns == header.size())
+			return false;
+		while(std::getline(is, line)) {
+			const std::vector<std::string> fields = split_csv(line);
+			if(fields.size() == header.size())
+				out[fields[name]] = std::atof(fields[ns].c_str());
+		}
+		return true;
+	}
+
+	void print(const result& r)
+	{
+		if(m_options.csv) {
+			if(m_results.empty()) {
+				std::fprintf(m_out, "# cpu: %s\n# build: %s\n", cpu_model().c_str(),
+					     BENCH_BUILD);
+				std::fprintf(m_out, "name,element_size,capacity,bytes,ops,"
+					     "ns_per_op,ns_per_op_min,mops_per_s");
+				for(const char* n : perf_counters::names)
+					std::fprintf(m_out, ",%s_per_op", n);
+				std::fprintf(m_out, "\n");
+			}
+			std::fprintf(m_out, "\"%s\",%zu,%zu,%zu,%llu", r.name.c_str(),
+				     r.element_size, r.capacity, r.element_size * r.capacity,
+				     static_cast<unsigned long long>(r.ops));
+			std::fprintf(m_out, ",%.4f,%.4f,%.2f", r.ns, r.ns_min, 1e3 / r.ns);
+			for(double c : r.counters) {
+				if(c >= 0)
+					std::fprintf(m_out, ",%.4f", c);
+				else
+					std::fprintf(m_out, ",");
+			}
+			std::fprintf(m_out, "\n");
+		} else {
+			if(m_results.empty()) {
+				std::fprintf(m_out, "%-40s %10s %10s", "benchmark", "ns/op",
+					     "Mops/s");
+				if(use_counters())
+					for(const char* n : perf_counters::names)
+						std::fprintf(m_out, " %14s", n);
+				std::fprintf(m_out, "\n");
+			}
+			std::string name = r.name;
+			if(r.capacity) {
+				name += " " + std::to_string(r.capacity) + " x "
+					+ std::to_string(r.element_size) + " B";
+			}
+			std::fprintf(m_out, "%-40s %10.3f %10.2f", name.c_str(), r.ns, 1e3 / r.ns);
+			if(use_counters()) {
+				for(double c : r.counters) {
+					if(c >= 0)
+						std::fprintf(m_out, " %14.3f", c);
+					else
+						std::fprintf(m_out, " %14s", "-");
+				}
+			}
+			std::fprintf(m_out, "\n");
+		}
+		std::fflush(m_out);
+	}
+
+	options m_options;
+	std::size_t m_element_size;
+	std::size_t m_capacity;
+	std::FILE* m_out;
+	perf_counters m_counters;
+	std::vector<result> m_results;
+	std::chrono::steady_clock::time_point m_pause_start;
+	std::chrono::steady_clock::duration m_paused; // Within the current repetition
+};
+
+} // namespace bench
+
+#endif /* BENCH_H */
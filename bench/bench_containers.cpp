@@ -0,0 +1,240 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#	include <unistd.h>
+#endif
+
+#include "bench.hxx"
+#include "cc/buffer.hxx"
+#include "cc/fifo.hxx"
+
+/**
+ * Benchmarks of `cc::fifo` operations, on a fifo with room for `Nm` elements of `Tp`.
+ */
+template <typename Tp, std::size_t Nm>
+static void bench_fifo(bench::runner& r, const std::string& label)
+{
+	constexpr std::size_t batch = std::min<std::size_t>(64, Nm / 2);
+	auto f = std::make_unique<cc::fifo<Tp, Nm>>(); // May not fit on the stack
+	Tp in[batch] = {}, out[batch];
+
+	// Push and pop one at a time, at half fill, so the indices wrap around
+	f->truncate();
+	for(std::size_t i = 0; i < Nm / 2; i++)
+		f->push(Tp());
+	r.run(label + "/push+pop", 1, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			f->push(in[i % batch]);
+			bench::do_not_optimize(f->pop());
+		}
+	});
+
+	r.run(label + "/push_list+pop_list", batch, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			f->push_list(in, in + batch);
+			f->pop_list(out, batch);
+			bench::do_not_optimize(out[0]);
+		}
+	});
+
+	// Each of the above on its own: fill from empty, or drain from full, the other phase not
+	// being timed
+	const auto fill = [&] {
+		f->truncate();
+		for(std::size_t j = 0; j < Nm; j++)
+			f->push(in[j % batch]);
+	};
+	r.run(label + "/push", Nm, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++)
+			fill();
+		bench::do_not_optimize(f->back());
+	});
+
+	r.run(label + "/pop", Nm, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			r.pause();
+			fill();
+			r.resume();
+			Tp sum = Tp();
+			for(std::size_t j = 0; j < Nm; j++)
+				sum += f->pop();
+			bench::do_not_optimize(sum);
+		}
+	});
+
+	r.run(label + "/push_list", Nm / batch * batch, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			f->truncate();
+			for(std::size_t j = 0; j + batch <= Nm; j += batch)
+				f->push_list(in, in + batch);
+		}
+		bench::do_not_optimize(f->back());
+	});
+
+	r.run(label + "/pop_list", Nm / batch * batch, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			r.pause();
+			fill();
+			r.resume();
+			for(std::size_t j = 0; j + batch <= Nm; j += batch)
+				f->pop_list(out, batch);
+			bench::do_not_optimize(out[0]);
+		}
+	});
+
+	// Fill to the brim, straddling the end of the array
+	f->truncate();
+	for(std::size_t i = 0; i < Nm / 2; i++)
+		f->push(Tp());
+	f->discard(Nm / 2);
+	while(!f->full())
+		f->push(Tp(1));
+	r.run(label + "/iterate", Nm, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			Tp sum = Tp();
+			for(const Tp& v : *f)
+				sum += v;
+			bench::do_not_optimize(sum);
+		}
+	});
+}
+
+/**
+ * Benchmarks of `cc::buffer` operations, on a buffer with room for `Nm` elements of `Tp`.
+ */
+template <typename Tp, std::size_t Nm>
+static void bench_buffer(bench::runner& r, const std::string& label)
+{
+	constexpr std::size_t batch = std::min<std::size_t>(64, Nm);
+	auto b = std::make_unique<cc::buffer<Tp, Nm>>();
+	Tp in[batch] = {};
+
+	r.run(label + "/push_back", Nm, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			b->reset();
+			for(std::size_t j = 0; j < Nm; j++)
+				b->push_back(in[j % batch]);
+			bench::do_not_optimize(b->back());
+		}
+	});
+
+	r.run(label + "/append", Nm / batch * batch, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			b->reset();
+			for(std::size_t j = 0; j + batch <= Nm; j += batch)
+				b->append(in, in + batch);
+			bench::do_not_optimize(b->back());
+		}
+	});
+
+	b->fill_all(Tp(1));
+	r.run(label + "/iterate", Nm, [&](std::uint64_t n) {
+		for(std::uint64_t i = 0; i < n; i++) {
+			Tp sum = Tp();
+			for(const Tp& v : *b)
+				sum += v;
+			bench::do_not_optimize(sum);
+		}
+	});
+}
+
+/**
+ * Element of `Bytes` bytes for the capacity sweep. Adding touches the first word only, so
+ * iterating measures memory traffic rather than arithmetic.
+ */
+template <std::size_t Bytes>
+struct element {
+	static_assert(Bytes % 4 == 0, "Whole 32-bit words");
+
+	element(std::uint32_t v = 0)
+		: words{v}
+	{}
+
+	element& operator+=(const element& other)
+	{
+		words[0] += other.words[0];
+		return *this;
+	}
+
+	std::uint32_t words[Bytes / 4];
+};
+
+// Largest container in the sweep, beyond the last-level cache of current server CPUs
+constexpr std::size_t sweep_max_bytes = std::size_t(256) << 20;
+
+template <std::size_t Bytes, std::size_t Nm>
+static void sweep_capacity(bench::runner& r)
+{
+	if constexpr(Bytes * Nm <= sweep_max_bytes) {
+		r.shape(Bytes, Nm);
+		bench_fifo<element<Bytes>, Nm>(r, "fifo");
+		bench_buffer<element<Bytes>, Nm>(r, "buffer");
+	}
+}
+
+/**
+ * Run all benchmarks with elements of `Bytes` bytes, for capacities from 16 elements up to
+ * sweep_max_bytes, in steps of 4x.
+ */
+template <std::size_t Bytes, std::size_t... Steps>
+static void sweep(bench::runner& r, std::index_sequence<Steps...>)
+{
+	(sweep_capacity<Bytes, std::size_t(16) << (2 * Steps)>(r), ...);
+}
+
+/**
+ * Print the cache sizes, to place the knees of the sweep.
+ */
+static void print_caches()
+{
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+	std::fprintf(stderr, "Caches: L1d %ld KiB, L2 %ld KiB, L3 %ld KiB\n",
+		     sysconf(_SC_LEVEL1_DCACHE_SIZE) / 1024, sysconf(_SC_LEVEL2_CACHE_SIZE) / 1024,
+		     sysconf(_SC_LEVEL3_CACHE_SIZE) / 1024);
+#endif
+}
+
+/**
+ * Run the benchmarks selected by the options once.
+ */
+static void run_all(bench::runner& r)
+{
+	if(r.config().sweep) {
+		// Throughput against the size of the container, for each operation
+		print_caches();
+		sweep<4>(r, std::make_index_sequence<12>());
+		sweep<16>(r, std::make_index_sequence<12>());
+		sweep<64>(r, std::make_index_sequence<12>());
+		return;
+	}
+
+	r.shape(sizeof(std::uint32_t), 1024);
+	bench_fifo<std::uint32_t, 1024>(r, "fifo<uint32_t,1024>");
+	bench_buffer<std::uint32_t, 1024>(r, "buffer<uint32_t,1024>");
+	r.shape(sizeof(double), 1024);
+	bench_fifo<double, 1024>(r, "fifo<double,1024>");
+	bench_buffer<double, 1024>(r, "buffer<double,1024>");
+}
+
+int main(int argc, char** argv)
+{
+	bench::runner r(bench::options::parse(argc, argv));
+	const bench::options& o = r.config();
+
+	// Against a baseline, for the perf tests, fail only when every run is slower: a busy
+	// machine slows down a run now and then, a regression slows down all of them
+	for(int attempt = 1;; attempt++) {
+		run_all(r);
+		if(!o.baseline || r.compare(o.baseline))
+			return 0;
+		if(attempt >= o.attempts)
+			return 1;
+		std::fprintf(stderr, "Slower than the baseline, running again (%d of %d)\n",
+			     attempt + 1, o.attempts);
+		r.clear();
+	}
+}
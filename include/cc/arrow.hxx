@@ -0,0 +1,157 @@
+#ifndef CC_ARROW_H
+#define CC_ARROW_H
+
+#include <cstdint>
+
+#include "buffer.hxx"
+#include "fifo.hxx"
+
+// Apache Arrow C Data Interface, copied verbatim from the specification so no Arrow headers are
+// needed. The guard makes it coexist with Arrow's own copy.
+#ifndef ARROW_C_DATA_INTERFACE
+#	define ARROW_C_DATA_INTERFACE
+
+#	define ARROW_FLAG_DICTIONARY_ORDERED 1
+#	define ARROW_FLAG_NULLABLE	      2
+#	define ARROW_FLAG_MAP_KEYS_SORTED    4
+
+extern "C" {
+
+struct ArrowSchema {
+	// Array type description
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowSchema*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+struct ArrowArray {
+	// Array data description
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowArray*);
+	// Opaque producer-specific data
+	void* private_data;
+};
+
+} // extern "C"
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace cc {
+
+/**
+ * Arrow format string of a primitive type.
+ *
+ * Only types whose memory layout matches Arrow's are defined, other types fail to compile.
+ */
+template <typename Tp>
+struct arrow_format;
+
+// clang-format off
+template <> struct arrow_format<std::int8_t>   { static constexpr const char* value = "c"; };
+template <> struct arrow_format<std::uint8_t>  { static constexpr const char* value = "C"; };
+template <> struct arrow_format<std::int16_t>  { static constexpr const char* value = "s"; };
+template <> struct arrow_format<std::uint16_t> { static constexpr const char* value = "S"; };
+template <> struct arrow_format<std::int32_t>  { static constexpr const char* value = "i"; };
+template <> struct arrow_format<std::uint32_t> { static constexpr const char* value = "I"; };
+template <> struct arrow_format<std::int64_t>  { static constexpr const char* value = "l"; };
+template <> struct arrow_format<std::uint64_t> { static constexpr const char* value = "L"; };
+template <> struct arrow_format<float>         { static constexpr const char* value = "f"; };
+template <> struct arrow_format<double>        { static constexpr const char* value = "g"; };
+// clang-format on
+
+namespace detail {
+
+inline void arrow_release_schema(ArrowSchema* schema)
+{
+	// Only static strings are referenced
+	schema->release = nullptr;
+}
+
+inline void arrow_release_array(ArrowArray* array)
+{
+	delete[] static_cast<const void**>(array->private_data);
+	array->private_data = nullptr;
+	array->buffers = nullptr;
+	array->release = nullptr;
+}
+
+template <typename Tp>
+void arrow_export_schema(ArrowSchema* schema)
+{
+	*schema = ArrowSchema{};
+	schema->format = arrow_format<Tp>::value;
+	schema->release = &arrow_release_schema;
+}
+
+template <typename Tp>
+void arrow_export_array(const Tp* data, std::size_t length, ArrowArray* array)
+{
+	// Validity bitmap (absent, no nulls) and values
+	const void** buffers = new const void*[2]{nullptr, data};
+
+	*array = ArrowArray{};
+	array->length = static_cast<int64_t>(length);
+	array->n_buffers = 2;
+	array->buffers = buffers;
+	array->release = &arrow_release_array;
+	array->private_data = buffers;
+}
+
+} // namespace detail
+
+/**
+ * Expose the used elements of a buffer as an Arrow primitive array, without copying.
+ *
+ * The array refers to the buffer's memory: keep the buffer alive and unmodified until the
+ * consumer has called the release callbacks.
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+void export_arrow(const buffer<Tp, Nm, Trace>& b, ArrowArray* array, ArrowSchema* schema)
+{
+	detail::arrow_export_schema<Tp>(schema);
+	detail::arrow_export_array(b.data(), b.size(), array);
+}
+
+/**
+ * Expose the used elements of a fifo as Arrow primitive arrays, without copying.
+ *
+ * Each segment of the fifo becomes one array (think of the chunks of a chunked array), all
+ * sharing the same schema. An empty fifo gives a single empty array.
+ *
+ * The arrays refer to the fifo's memory: keep the fifo alive and don't pop from it until the
+ * consumer has called the release callbacks.
+ *
+ * @return Number of arrays exported in `arrays`, 1 or 2
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+std::size_t export_arrow(const fifo<Tp, Nm, Trace>& f, ArrowArray (&arrays)[2], ArrowSchema* schema)
+{
+	detail::arrow_export_schema<Tp>(schema);
+	detail::arrow_export_array(f.first_segment(), f.first_segment_size(), &arrays[0]);
+	if(f.second_segment_size() == 0)
+		return 1;
+
+	detail::arrow_export_array(f.second_segment(), f.second_segment_size(), &arrays[1]);
+	return 2;
+}
+
+} // namespace cc
+
+#endif /* CC_ARROW_H */
@@ -0,0 +1,365 @@
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__BMI2__)
+#	include <immintrin.h>
+#endif
+
+#include "buffer.hxx"
+#include "fifo.hxx"
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Keep the lowest `n` bits of `x`, for 0 <= n <= 64.
+ */
+inline std::uint64_t low_bits(std::uint64_t x, unsigned n) noexcept
+{
+#if defined(__BMI2__)
+	return _bzhi_u64(x, n);
+#else
+	return n >= 64 ? x : x & ((std::uint64_t(1) << n) - 1u);
+#endif
+}
+
+/**
+ * A mask with the lowest `bits` bits set in each of the four 16-bit lanes.
+ */
+inline std::uint64_t lane16_mask(unsigned bits) noexcept
+{
+	return low_bits(~std::uint64_t(0), bits) * 0x0001000100010001u;
+}
+
+/**
+ * Gather the masked bits of `x` into the low end (like BMI2's `pext`).
+ */
+inline std::uint64_t pext(std::uint64_t x, std::uint64_t mask) noexcept
+{
+#if defined(__BMI2__)
+	return _pext_u64(x, mask);
+#else
+	std::uint64_t res = 0;
+	for(std::uint64_t bit = 1; mask; bit <<= 1) {
+		if(x & mask & (0u - mask))
+			res |= bit;
+		mask &= mask - 1u;
+	}
+	return res;
+#endif
+}
+
+/**
+ * Scatter the low bits of `x` over the masked positions (like BMI2's `pdep`).
+ */
+inline std::uint64_t pdep(std::uint64_t x, std::uint64_t mask) noexcept
+{
+#if defined(__BMI2__)
+	return _pdep_u64(x, mask);
+#else
+	std::uint64_t res = 0;
+	for(std::uint64_t bit = 1; mask; bit <<= 1) {
+		if(x & bit)
+			res |= mask & (0u - mask);
+		mask &= mask - 1u;
+	}
+	return res;
+#endif
+}
+
+inline std::uint64_t load_le64(const std::uint8_t* p) noexcept
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	std::uint64_t x;
+	std::memcpy(&x, p, sizeof(x));
+	return x;
+#else
+	std::uint64_t x = 0;
+	for(unsigned i = 0; i < 8; i++)
+		x |= std::uint64_t(p[i]) << (8 * i);
+	return x;
+#endif
+}
+
+inline void store_le64(std::uint8_t* p, std::uint64_t x) noexcept
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	std::memcpy(p, &x, sizeof(x));
+#else
+	for(unsigned i = 0; i < 8; i++)
+		p[i] = static_cast<std::uint8_t>(x >> (8 * i));
+#endif
+}
+
+/**
+ * Byte-wise access to the containers a bit stream can be stored in.
+ */
+template <typename Container>
+struct byte_stream;
+
+template <std::size_t Nm, typename Trace>
+struct byte_stream<buffer<std::uint8_t, Nm, Trace>> {
+	explicit byte_stream(buffer<std::uint8_t, Nm, Trace>& b)
+		: container(b)
+		, pos(0)
+	{}
+
+	void append(const std::uint8_t* p, std::size_t n)
+	{
+		if(container.free() < n)
+			std::__throw_out_of_range("bit_writer"); // Not enough space left
+		std::memcpy(container.data() + container.size(), p, n);
+		container.reset(container.size() + n);
+	}
+
+	std::size_t take(std::uint8_t* p, std::size_t n)
+	{
+		n = std::min(n, container.size() - pos);
+		std::memcpy(p, container.data() + pos, n);
+		pos += n;
+		return n;
+	}
+
+	std::size_t remaining() const noexcept
+	{
+		return container.size() - pos;
+	}
+
+	buffer<std::uint8_t, Nm, Trace>& container;
+	std::size_t pos; // Read position; a buffer is not consumed by reading
+};
+
+template <std::size_t Nm, typename Trace>
+struct byte_stream<fifo<std::uint8_t, Nm, Trace>> {
+	explicit byte_stream(fifo<std::uint8_t, Nm, Trace>& f)
+		: container(f)
+	{}
+
+	void append(const std::uint8_t* p, std::size_t n)
+	{
+		container.push_list(p, p + n);
+	}
+
+	std::size_t take(std::uint8_t* p, std::size_t n)
+	{
+		n = std::min(n, container.size());
+		if(n)
+			container.pop_list(p, n);
+		return n;
+	}
+
+	std::size_t remaining() const noexcept
+	{
+		return container.size();
+	}
+
+	fifo<std::uint8_t, Nm, Trace>& container;
+};
+
+} // namespace detail
+
+/**
+ * Packs fields of arbitrary bit width into a byte buffer or fifo.
+ *
+ * Fields are stored least significant bit first, in little-endian byte order. Bits are collected
+ * in a 64-bit accumulator and appended eight bytes at a time, so call flush() to append the
+ * remaining bits (padded to a whole byte) when done.
+ *
+ * @tparam Container `cc::buffer<std::uint8_t, N>` or `cc::fifo<std::uint8_t, N>`
+ */
+template <typename Container>
+class bit_writer {
+public:
+	explicit bit_writer(Container& sink)
+		: m_sink(sink)
+		, m_acc(0)
+		, m_bits(0)
+	{}
+
+	/**
+	 * Append the lowest `bits` bits of `value`, 0 <= bits <= 64.
+	 */
+	void write(std::uint64_t value, unsigned bits)
+	{
+		value = detail::low_bits(value, bits);
+		m_acc |= value << m_bits; // m_bits is always below 64
+
+		if(m_bits + bits < 64) {
+			m_bits += bits;
+			return;
+		}
+
+		std::uint8_t chunk[8];
+		detail::store_le64(chunk, m_acc);
+		m_sink.append(chunk, sizeof(chunk));
+
+		const unsigned consumed = 64 - m_bits; // 1..64
+		m_acc = consumed < 64 ? value >> consumed : 0;
+		m_bits = m_bits + bits - 64;
+	}
+
+	/**
+	 * Append `n` fields of `bits` bits each, 0 <= bits <= 16.
+	 *
+	 * With BMI2, four fields at a time are packed by a single `pext`.
+	 */
+	void write_list(const std::uint16_t* values, std::size_t n, unsigned bits)
+	{
+		const std::uint64_t mask = detail::lane16_mask(bits);
+		std::size_t i = 0;
+
+		for(; i + 4 <= n; i += 4) {
+			std::uint64_t lanes;
+			std::memcpy(&lanes, values + i, sizeof(lanes));
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+			lanes = std::uint64_t(values[i]) | std::uint64_t(values[i + 1]) << 16
+				| std::uint64_t(values[i + 2]) << 32
+				| std::uint64_t(values[i + 3]) << 48;
+#endif
+			write(detail::pext(lanes, mask), 4 * bits);
+		}
+
+		for(; i < n; i++)
+			write(values[i], bits);
+	}
+
+	/**
+	 * Append all pending bits, padding the last byte with zeros.
+	 *
+	 * Writing may continue afterwards, starting at the next byte.
+	 */
+	void flush()
+	{
+		if(m_bits == 0)
+			return;
+
+		std::uint8_t chunk[8];
+		detail::store_le64(chunk, m_acc);
+		m_sink.append(chunk, (m_bits + 7) / 8);
+		m_acc = 0;
+		m_bits = 0;
+	}
+
+	/**
+	 * Number of bits written, but not yet appended to the container.
+	 */
+	unsigned pending() const noexcept
+	{
+		return m_bits;
+	}
+
+private:
+	detail::byte_stream<Container> m_sink;
+	std::uint64_t m_acc; // Pending bits, from the bottom up
+	unsigned m_bits;     // Number of pending bits in m_acc
+};
+
+/**
+ * Unpacks fields of arbitrary bit width from a byte buffer or fifo, as written by bit_writer.
+ *
+ * A buffer is read from the start and left untouched; bytes are popped from a fifo as they are
+ * needed (up to eight bytes ahead of the fields that were read).
+ *
+ * @tparam Container `cc::buffer<std::uint8_t, N>` or `cc::fifo<std::uint8_t, N>`
+ */
+template <typename Container>
+class bit_reader {
+public:
+	explicit bit_reader(Container& source)
+		: m_source(source)
+		, m_acc(0)
+		, m_bits(0)
+	{}
+
+	/**
+	 * Read a field of `bits` bits, 0 <= bits <= 64.
+	 */
+	std::uint64_t read(unsigned bits)
+	{
+		if(bits > 56) {
+			// Refill only guarantees 57 bits
+			const std::uint64_t lo = read(32);
+			return lo | read(bits - 32) << 32;
+		}
+
+		if(m_bits < bits) {
+			refill();
+			if(m_bits < bits)
+				// Not enough bits left
+				std::__throw_out_of_range("bit_reader::read");
+		}
+
+		const std::uint64_t v = detail::low_bits(m_acc, bits);
+		m_acc >>= bits;
+		m_bits -= bits;
+		return v;
+	}
+
+	/**
+	 * Read `n` fields of `bits` bits each, 0 <= bits <= 16.
+	 *
+	 * With BMI2, four fields at a time are unpacked by a single `pdep`.
+	 */
+	void read_list(std::uint16_t* values, std::size_t n, unsigned bits)
+	{
+		const std::uint64_t mask = detail::lane16_mask(bits);
+		std::size_t i = 0;
+
+		for(; i + 4 <= n; i += 4) {
+			const std::uint64_t lanes = detail::pdep(read(4 * bits), mask);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			std::memcpy(values + i, &lanes, sizeof(lanes));
+#else
+			for(unsigned k = 0; k < 4; k++)
+				values[i + k] = static_cast<std::uint16_t>(lanes >> (16 * k));
+#endif
+		}
+
+		for(; i < n; i++)
+			values[i] = static_cast<std::uint16_t>(read(bits));
+	}
+
+	/**
+	 * Skip the remaining bits of the current byte, like the padding of bit_writer::flush().
+	 */
+	void align() noexcept
+	{
+		const unsigned skip = m_bits % 8;
+		m_acc >>= skip;
+		m_bits -= skip;
+	}
+
+	/**
+	 * Number of bits left to read.
+	 */
+	std::size_t available() const noexcept
+	{
+		return m_bits + 8 * m_source.remaining();
+	}
+
+private:
+	void refill()
+	{
+		std::uint8_t chunk[8] = {};
+		const std::size_t n = m_source.take(chunk, (64 - m_bits) / 8);
+		if(n == 0)
+			return;
+
+		m_acc |= detail::load_le64(chunk) << m_bits;
+		m_bits += static_cast<unsigned>(8 * n);
+	}
+
+	detail::byte_stream<Container> m_source;
+	std::uint64_t m_acc; // Bits read ahead, from the bottom up
+	unsigned m_bits;     // Number of valid bits in m_acc
+};
+
+} // namespace cc
+
+#endif /* BITSTREAM_H */
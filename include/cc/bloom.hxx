@@ -0,0 +1,241 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <array>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+#include "hash.hxx"
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Odd multipliers that derive each probe of a blocked Bloom filter from one 32-bit hash. The
+ * first eight are the ones of the Parquet split block filter.
+ */
+alignas(64) inline constexpr std::uint32_t bloom_salts[16] = {
+	0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du, 0x705495C7u, 0x2DF1424Bu,
+	0x9EFC4947u, 0x5C6BFB31u, 0x9E3779B1u, 0x85EBCA77u, 0xC2B2AE3Du, 0x27D4EB2Fu,
+	0x165667B1u, 0xD35A2D97u, 0xFD7046C5u, 0xB55A4F09u,
+};
+
+} // namespace detail
+
+/**
+ * Bloom filter with a cache-line-blocked layout, stored inline.
+ *
+ * The `Bits` bits are split into blocks of one 64-byte cache line. A key selects one block with
+ * the upper half of its hash, and sets `K` bits in that block, each derived from the lower half
+ * with its own multiplier. A lookup so costs a single cache miss instead of K, for a slightly
+ * higher false positive rate than an unblocked filter of the same size.
+ *
+ * With AVX2, the K bits of a key are tested at once with a gather from the block. The batch
+ * contains() hashes keys ahead and prefetches their blocks, so the misses of consecutive
+ * lookups overlap.
+ *
+ * @code
+ * cc::bloom<1 << 20, 8> seen; // 128 KiB, about 1% false positives for 100k keys
+ * seen.insert(id);
+ * if(seen.contains(id))
+ *         lookup(id); // Maybe present
+ * @endcode
+ *
+ * @tparam Bits Number of bits, a multiple of 512
+ * @tparam K Number of bits set per key, at most 16
+ */
+template <std::size_t Bits, std::size_t K>
+class bloom {
+	static_assert(Bits > 0 && Bits % 512 == 0, "Bits must be a whole number of cache lines");
+	static_assert(Bits / 512 <= 0xFFFFFFFF, "Block index must fit in 32 bits");
+	static_assert(K > 0 && K <= 16, "Need 1 to 16 bits per key");
+
+public:
+	bloom()
+		: m_words()
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Remove all keys.
+	 */
+	void reset()
+	{
+		m_words.fill(0);
+	}
+
+	static constexpr std::size_t size() noexcept
+	{
+		return Bits;
+	}
+
+	static constexpr std::size_t blocks() noexcept
+	{
+		return Bits / 512;
+	}
+
+	static constexpr std::size_t hashes() noexcept
+	{
+		return K;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	template <typename Key>
+	void insert(const Key& key)
+	{
+		const std::uint64_t h = detail::sketch_hash(key);
+		std::uint32_t* b = block(h);
+		for(std::size_t i = 0; i < K; i++) {
+			const std::uint32_t pos = probe(h, i);
+			b[pos >> 5] |= 1u << (pos & 31);
+		}
+	}
+
+	template <typename Key>
+	void insert(const Key* first, const Key* last)
+	{
+		for(; first != last; first++)
+			insert(*first);
+	}
+
+	/**
+	 * Add all keys of another filter of the same size.
+	 */
+	void merge(const bloom& other)
+	{
+		for(std::size_t i = 0; i < m_words.size(); i++)
+			m_words[i] |= other.m_words[i];
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Check whether a key may have been inserted. False positives are possible, false negatives
+	 * are not.
+	 */
+	template <typename Key>
+	bool contains(const Key& key) const
+	{
+		return test(detail::sketch_hash(key));
+	}
+
+	/**
+	 * Check a batch of keys, and set bit `i % 64` of `mask[i / 64]` for each key `i` that may
+	 * have been inserted, clearing the others. The mask can be passed to `cc::buffer::compact`.
+	 *
+	 * @return Number of keys that may have been inserted
+	 */
+	template <typename Key>
+	std::size_t contains(const Key* first, const Key* last, std::uint64_t* mask) const
+	{
+		constexpr std::size_t ahead = 8; // Blocks prefetched before they are tested
+		const std::size_t n = static_cast<std::size_t>(last - first);
+		std::uint64_t hashes[ahead];
+		std::size_t found = 0;
+
+		for(std::size_t i = 0; i < n && i < ahead; i++) {
+			hashes[i] = detail::sketch_hash(first[i]);
+			__builtin_prefetch(block(hashes[i]));
+		}
+		for(std::size_t i = 0; i < n; i++) {
+			const std::uint64_t h = hashes[i % ahead];
+			if(i + ahead < n) {
+				hashes[i % ahead] = detail::sketch_hash(first[i + ahead]);
+				__builtin_prefetch(block(hashes[i % ahead]));
+			}
+			if(i % 64 == 0)
+				mask[i / 64] = 0;
+			const bool hit = test(h);
+			mask[i / 64] |= static_cast<std::uint64_t>(hit) << (i % 64);
+			found += hit;
+		}
+		return found;
+	}
+
+	/* @} */
+
+protected:
+	static constexpr std::size_t block_words = 16; // 32-bit words per cache line
+
+	/**
+	 * Get the block of hash `h`, from its upper half.
+	 */
+	std::uint32_t* block(std::uint64_t h) noexcept
+	{
+		return m_words.data() + ((h >> 32) * blocks() >> 32) * block_words;
+	}
+
+	const std::uint32_t* block(std::uint64_t h) const noexcept
+	{
+		return m_words.data() + ((h >> 32) * blocks() >> 32) * block_words;
+	}
+
+	/**
+	 * Get the bit position of probe `i` within the block, from the lower half of `h`.
+	 */
+	static std::uint32_t probe(std::uint64_t h, std::size_t i) noexcept
+	{
+		return static_cast<std::uint32_t>(h) * detail::bloom_salts[i] >> 23;
+	}
+
+	bool test(std::uint64_t h) const noexcept
+	{
+		const std::uint32_t* b = block(h);
+#if defined(__AVX2__)
+		const int* base = reinterpret_cast<const int*>(b);
+		const __m256i hv = _mm256_set1_epi32(static_cast<int>(h & 0xFFFFFFFF));
+		const __m256i low = _mm256_set1_epi32(31);
+		const __m256i one = _mm256_set1_epi32(1);
+		for(std::size_t i = 0; i < K; i += 8) {
+			const __m256i salts = _mm256_load_si256(
+				reinterpret_cast<const __m256i*>(detail::bloom_salts + i));
+			const __m256i pos = _mm256_srli_epi32(_mm256_mullo_epi32(hv, salts), 23);
+			__m256i bits = _mm256_sllv_epi32(one, _mm256_and_si256(pos, low));
+			if(K - i < 8) {
+				// Probes beyond K test no bit
+				const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+				const __m256i valid = _mm256_cmpgt_epi32(
+					_mm256_set1_epi32(static_cast<int>(K - i)), lane);
+				bits = _mm256_and_si256(bits, valid);
+			}
+			const __m256i words =
+				_mm256_i32gather_epi32(base, _mm256_srli_epi32(pos, 5), 4);
+			if(!_mm256_testc_si256(words, bits))
+				return false;
+		}
+		return true;
+#else
+		for(std::size_t i = 0; i < K; i++) {
+			const std::uint32_t pos = probe(h, i);
+			if(!(b[pos >> 5] >> (pos & 31) & 1))
+				return false;
+		}
+		return true;
+#endif
+	}
+
+	alignas(64) std::array<std::uint32_t, Bits / 32> m_words;
+};
+
+} // namespace cc
+
+#endif /* BLOOM_H */
@@ -1,13 +1,105 @@
 #ifndef buffer_H
 #define buffer_H
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "trace.hxx"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#	include <immintrin.h>
+#endif
 
 /**
  * Custom containers.
  */
 namespace cc {
 
+namespace detail {
+
+/**
+ * Lane indices of the set bits of each 8-bit mask, one byte per lane, for AVX2 compaction.
+ */
+constexpr std::array<std::uint64_t, 256> make_compact_indices() noexcept
+{
+	std::array<std::uint64_t, 256> t{};
+	for(unsigned m = 0; m < 256; m++) {
+		unsigned k = 0;
+		for(unsigned lane = 0; lane < 8; lane++)
+			if(m & (1u << lane))
+				t[m] |= static_cast<std::uint64_t>(lane) << (8 * k++);
+	}
+	return t;
+}
+
+inline constexpr std::array<std::uint64_t, 256> compact_indices = make_compact_indices();
+
+/**
+ * Copy the elements of `src` whose bit is set in `mask` to `dst`, in order.
+ *
+ * Bit `i % 64` of `mask[i / 64]` selects element `i`. `dst` may be equal to `src` or lie before
+ * it; the vector stores can write a full vector past the kept elements, but never beyond what
+ * was already read.
+ *
+ * @tparam Capacity Upper bound of `n`; the vector loops are left out when a vector cannot
+ *         fit, so the compiler can see they stay within small arrays
+ * @return Number of elements kept
+ */
+template <std::size_t Capacity, typename Tp>
+inline std::size_t compact(const Tp* src, std::size_t n, const std::uint64_t* mask, Tp* dst)
+{
+	std::size_t i = 0;
+	std::size_t o = 0;
+
+	if constexpr(std::is_trivially_copyable<Tp>::value && sizeof(Tp) == 4) {
+#if defined(__AVX512F__)
+		if constexpr(Capacity >= 16) {
+			for(; i + 16 <= n; i += 16) {
+				const auto m = static_cast<__mmask16>(mask[i / 64] >> (i % 64));
+				const __m512i v = _mm512_loadu_si512(src + i);
+				_mm512_mask_compressstoreu_epi32(dst + o, m, v);
+				o += static_cast<std::size_t>(__builtin_popcount(m));
+			}
+		}
+#elif defined(__AVX2__)
+		if constexpr(Capacity >= 8) {
+			for(; i + 8 <= n; i += 8) {
+				const auto m = static_cast<std::uint8_t>(mask[i / 64] >> (i % 64));
+				const auto lanes = static_cast<long long>(compact_indices[m]);
+				const __m256i idx = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(lanes));
+				const auto* in = reinterpret_cast<const __m256i*>(src + i);
+				const __m256i v = _mm256_loadu_si256(in);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + o),
+						    _mm256_permutevar8x32_epi32(v, idx));
+				o += static_cast<std::size_t>(__builtin_popcount(m));
+			}
+		}
+#endif
+	} else if constexpr(std::is_trivially_copyable<Tp>::value && sizeof(Tp) == 8) {
+#if defined(__AVX512F__)
+		if constexpr(Capacity >= 8) {
+			for(; i + 8 <= n; i += 8) {
+				const auto m = static_cast<__mmask8>(mask[i / 64] >> (i % 64));
+				const __m512i v = _mm512_loadu_si512(src + i);
+				_mm512_mask_compressstoreu_epi64(dst + o, m, v);
+				o += static_cast<std::size_t>(__builtin_popcount(m));
+			}
+		}
+#endif
+	}
+
+	// Branch-free: always copy, only advance the output for kept elements
+	for(; i < n; i++) {
+		dst[o] = src[i];
+		o += (mask[i / 64] >> (i % 64)) & 1u;
+	}
+	return o;
+}
+
+} // namespace detail
+
 /**
  * Extension of std::array that tracks the last used value, including a varying size.
  *
@@ -33,8 +125,9 @@ namespace cc {
  *
  * @tparam Tp Underlying type
  * @tparam Nm Max size of this buffer
+ * @tparam Trace Policy that receives push and pop events, see trace.hxx
  */
-template <typename Tp, std::size_t Nm>
+template <typename Tp, std::size_t Nm, typename Trace = CC_TRACE_POLICY>
 class buffer : public std::array<Tp, Nm> {
 public:
 	typedef Tp value_type;
@@ -57,7 +150,12 @@ public:
 	 */
 	void reset(std::size_t n = 0)
 	{
+		const std::size_t old = m_used;
 		m_used = n;
+		if(n < old)
+			trace_pop(old - n);
+		else if(n > old)
+			trace_push(n - old);
 	}
 
 	/**
@@ -108,7 +206,11 @@ public:
 	void assign(std::size_t n, const value_type& v)
 	{
 		this->at(n) = v;
-		m_used = std::max(m_used, n + 1);
+		if(n >= m_used) {
+			const std::size_t old = m_used;
+			m_used = n + 1;
+			trace_push(m_used - old);
+		}
 	}
 
 	/**
@@ -120,6 +222,7 @@ public:
 	{
 		this->at(m_used) = v;
 		m_used++;
+		trace_push(1);
 	}
 
 	value_type pop_back()
@@ -128,9 +231,76 @@ public:
 			std::__throw_out_of_range("buffer::pop");
 		auto v = this->at(m_used - 1);
 		m_used--;
+		trace_pop(1);
 		return v;
 	}
 
+	/**
+	 * Add multiple elements at the end.
+	 */
+	void append(const value_type* other_begin, const value_type* other_end)
+	{
+		const std::size_t n = other_end - other_begin;
+		if(free() < n)
+			std::__throw_out_of_range("buffer::append"); // Not enough space left
+		std::copy(other_begin, other_end, this->data() + m_used);
+		m_used += n;
+		trace_push(n);
+	}
+
+	/**
+	 * Add multiple elements of another type at the end, converting them on the way in.
+	 *
+	 * `convert(const Src* src, value_type* dst, std::size_t n)` is called once, so it can be a
+	 * vectorized kernel; see convert.hxx.
+	 */
+	template <typename Src, typename Convert>
+	void append(const Src* other_begin, const Src* other_end, Convert&& convert)
+	{
+		const std::size_t n = other_end - other_begin;
+		if(free() < n)
+			std::__throw_out_of_range("buffer::append"); // Not enough space left
+		convert(other_begin, this->data() + m_used, n);
+		m_used += n;
+		trace_push(n);
+	}
+
+	/**
+	 * Keep only the elements selected by a bit mask, in order, and shrink size() to match.
+	 *
+	 * Bit `i % 64` of `mask[i / 64]` selects element `i`, for all size() elements. Uses AVX-512
+	 * compress stores or AVX2 permutes for 4-byte elements (and AVX-512 for 8-byte ones).
+	 */
+	void compact(const std::uint64_t* mask)
+	{
+		const std::size_t n = m_used;
+		m_used = detail::compact<Nm>(this->data(), m_used, mask, this->data());
+		trace_pop(n - m_used);
+	}
+
+	/**
+	 * Keep only the elements for which `pred(v)` is true, in order, like a stable filter.
+	 *
+	 * The predicate is evaluated for all elements first, 64 at a time, so there are no
+	 * data-dependent branches.
+	 */
+	template <typename Pred>
+	void compact_if(Pred&& pred)
+	{
+		value_type* p = this->data();
+		std::size_t o = 0;
+		for(std::size_t i = 0; i < m_used; i += 64) {
+			const std::size_t n = std::min<std::size_t>(64, m_used - i);
+			std::uint64_t mask = 0;
+			for(std::size_t j = 0; j < n; j++)
+				mask |= static_cast<std::uint64_t>(pred(p[i + j]) ? 1 : 0) << j;
+			o += detail::compact<std::min<std::size_t>(Nm, 64)>(p + i, n, &mask, p + o);
+		}
+		const std::size_t n = m_used - o;
+		m_used = o;
+		trace_pop(n);
+	}
+
 	void fill_used(const value_type& v)
 	{
 		std::fill_n(this->begin(), m_used, v);
@@ -138,8 +308,11 @@ public:
 
 	void fill_all(const value_type& v)
 	{
+		const std::size_t old = m_used;
 		m_used = this->max_size();
 		std::fill_n(this->begin(), m_used, v);
+		if(m_used > old)
+			trace_push(m_used - old);
 	}
 
 	/* }@ */
@@ -200,6 +373,30 @@ public:
 	}
 
 protected:
+	/**
+	 * Report `n` added elements to the trace policy.
+	 */
+	void trace_push(std::size_t n) const
+	{
+		if constexpr(Trace::enabled) {
+			Trace::push("buffer", this, n, m_used);
+			if(m_used == this->max_size())
+				Trace::full("buffer", this, m_used);
+		}
+	}
+
+	/**
+	 * Report `n` removed elements to the trace policy.
+	 */
+	void trace_pop(std::size_t n) const
+	{
+		if constexpr(Trace::enabled) {
+			Trace::pop("buffer", this, n, m_used);
+			if(m_used == 0)
+				Trace::empty("buffer", this);
+		}
+	}
+
 	std::size_t m_used; // Number of elements that are considered 'used'
 };
 
@@ -0,0 +1,158 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE4_2__)
+#	include <nmmintrin.h>
+#endif
+
+#include "buffer.hxx"
+#include "fifo.hxx"
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Slicing-by-8 lookup tables for CRC32C (reflected polynomial 0x82F63B78).
+ */
+constexpr std::array<std::array<std::uint32_t, 256>, 8> crc32c_make_tables()
+{
+	std::array<std::array<std::uint32_t, 256>, 8> t{};
+	for(std::uint32_t i = 0; i < 256; i++) {
+		std::uint32_t c = i;
+		for(int k = 0; k < 8; k++)
+			c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1u)));
+		t[0][i] = c;
+	}
+	for(std::size_t i = 0; i < 256; i++)
+		for(std::size_t s = 1; s < 8; s++)
+			t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFFu];
+	return t;
+}
+
+inline constexpr std::array<std::array<std::uint32_t, 256>, 8> crc32c_tables =
+	crc32c_make_tables();
+
+inline std::uint32_t crc32c_update(std::uint32_t crc, const unsigned char* p, std::size_t n)
+{
+#if defined(__SSE4_2__)
+	for(; n > 0 && (reinterpret_cast<std::uintptr_t>(p) & 7u); n--)
+		crc = _mm_crc32_u8(crc, *p++);
+#	if defined(__x86_64__)
+	std::uint64_t crc64 = crc;
+	for(; n >= 8; n -= 8, p += 8) {
+		std::uint64_t w;
+		std::memcpy(&w, p, 8);
+		crc64 = _mm_crc32_u64(crc64, w);
+	}
+	crc = static_cast<std::uint32_t>(crc64);
+#	endif
+	for(; n > 0; n--)
+		crc = _mm_crc32_u8(crc, *p++);
+#else
+	const auto& t = crc32c_tables;
+	for(; n >= 8; n -= 8, p += 8) {
+		// Little-endian order of the bytes in the stream
+		const std::uint32_t lo = crc
+					 ^ (static_cast<std::uint32_t>(p[0])
+					    | static_cast<std::uint32_t>(p[1]) << 8
+					    | static_cast<std::uint32_t>(p[2]) << 16
+					    | static_cast<std::uint32_t>(p[3]) << 24);
+		crc = t[7][lo & 0xFFu] ^ t[6][(lo >> 8) & 0xFFu] ^ t[5][(lo >> 16) & 0xFFu]
+		      ^ t[4][lo >> 24] ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+	}
+	for(; n > 0; n--)
+		crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFFu];
+#endif
+	return crc;
+}
+
+} // namespace detail
+
+/**
+ * Incremental CRC32C (Castagnoli) checksum.
+ *
+ * Uses the SSE4.2 `crc32` instruction when the target supports it, and a table-driven
+ * implementation otherwise. Both give the same result.
+ *
+ * Elements are hashed as their object representation, so only trivially copyable types are
+ * accepted. Hashing a fifo covers both its segments, in order, without copying it out first.
+ *
+ * @code
+ * cc::crc32c crc;
+ * crc.update(block);        // A whole buffer or fifo
+ * crc.update(&sample, 1);   // Or element by element, as they are pushed
+ * store(block, crc.value());
+ * @endcode
+ */
+class crc32c {
+public:
+	explicit crc32c(std::uint32_t seed = 0)
+		: m_state(~seed)
+	{}
+
+	void reset(std::uint32_t seed = 0)
+	{
+		m_state = ~seed;
+	}
+
+	std::uint32_t value() const noexcept
+	{
+		return ~m_state;
+	}
+
+	void update(const void* data, std::size_t bytes)
+	{
+		m_state = detail::crc32c_update(
+			m_state, static_cast<const unsigned char*>(data), bytes);
+	}
+
+	template <typename Tp>
+	void update(const Tp* values, std::size_t n)
+	{
+		static_assert(std::is_trivially_copyable<Tp>::value, "Can only hash plain data");
+		update(static_cast<const void*>(values), n * sizeof(Tp));
+	}
+
+	/**
+	 * Hash the used elements of a buffer.
+	 */
+	template <typename Tp, std::size_t Nm, typename Trace>
+	void update(const buffer<Tp, Nm, Trace>& b)
+	{
+		update(b.data(), b.size());
+	}
+
+	/**
+	 * Hash the used elements of a fifo, from the oldest to the newest.
+	 */
+	template <typename Tp, std::size_t Nm, typename Trace>
+	void update(const fifo<Tp, Nm, Trace>& f)
+	{
+		update(f.first_segment(), f.first_segment_size());
+		update(f.second_segment(), f.second_segment_size());
+	}
+
+private:
+	std::uint32_t m_state;
+};
+
+/**
+ * Get the CRC32C of the used elements of a buffer or fifo.
+ */
+template <typename Container>
+std::uint32_t checksum(const Container& c)
+{
+	crc32c crc;
+	crc.update(c);
+	return crc.value();
+}
+
+} // namespace cc
+
+#endif /* CHECKSUM_H */
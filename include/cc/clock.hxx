@@ -0,0 +1,106 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+#	include <time.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#endif
+
+namespace cc {
+
+namespace detail {
+
+inline std::uint64_t steady_ns() noexcept
+{
+	const auto t = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+}
+
+} // namespace detail
+
+/**
+ * @defgroup Clocks
+ *
+ * Cheap clocks for timestamping elements. Each has `static std::uint64_t now()` in its own
+ * ticks, and `static std::uint64_t to_ns(std::uint64_t ticks)` to convert a difference of
+ * ticks to nanoseconds.
+ */
+/* @{ */
+
+/**
+ * CLOCK_MONOTONIC_COARSE, in nanoseconds: a plain memory read through the vDSO, but only as
+ * fine as the kernel tick (1 to 4 ms). Falls back to `std::chrono::steady_clock` elsewhere.
+ */
+struct coarse_clock {
+	static std::uint64_t now() noexcept
+	{
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+		return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000u
+		       + static_cast<std::uint64_t>(ts.tv_nsec);
+#else
+		return detail::steady_ns();
+#endif
+	}
+
+	static std::uint64_t to_ns(std::uint64_t ticks) noexcept
+	{
+		return ticks;
+	}
+};
+
+/**
+ * The time stamp counter, in cycles of its constant reference frequency: the cheapest clock
+ * with sub-microsecond resolution (about 20 cycles). Only meaningful on CPUs with an invariant
+ * TSC, which are all x86 CPUs of the last decade. Falls back to `std::chrono::steady_clock`
+ * elsewhere.
+ *
+ * The first to_ns() calibrates the frequency against `std::chrono::steady_clock`, which takes
+ * about a millisecond.
+ */
+struct tsc_clock {
+	static std::uint64_t now() noexcept
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return detail::steady_ns();
+#endif
+	}
+
+	static std::uint64_t to_ns(std::uint64_t ticks) noexcept
+	{
+		static const double ns_per_tick = calibrate();
+		return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick);
+	}
+
+protected:
+	static double calibrate() noexcept
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		const auto t0 = std::chrono::steady_clock::now();
+		const std::uint64_t c0 = __rdtsc();
+		auto t1 = t0;
+		while(t1 - t0 < std::chrono::milliseconds(1))
+			t1 = std::chrono::steady_clock::now();
+		const std::uint64_t c1 = __rdtsc();
+		const std::chrono::duration<double, std::nano> dt = t1 - t0;
+		return dt.count() / static_cast<double>(c1 - c0);
+#else
+		return 1.0;
+#endif
+	}
+};
+
+/* @} */
+
+} // namespace cc
+
+#endif /* CLOCK_H */
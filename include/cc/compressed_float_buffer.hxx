@@ -0,0 +1,274 @@
+#ifndef COMPRESSED_FLOAT_BUFFER_H
+#define COMPRESSED_FLOAT_BUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "bitstream.hxx"
+#include "buffer.hxx"
+
+namespace cc {
+
+/**
+ * Append-only buffer of floating point values, compressed with Gorilla's XOR encoding.
+ *
+ * Each value is XOR-ed with the previous one. An unchanged value takes a single bit, otherwise
+ * only the bits between the leading and trailing zeros of the XOR are stored, reusing the
+ * previous leading/trailing zero counts when the new bits fit within them. Slowly changing
+ * series typically shrink 5-10 times.
+ *
+ * Values can't be accessed individually; decode them in bulk to a `cc::buffer`, or use
+ * for_each().
+ *
+ * @tparam Nm Size of the compressed storage in bytes
+ * @tparam Tp `float` or `double`
+ */
+template <std::size_t Nm, typename Tp = float>
+class compressed_float_buffer {
+	static_assert(
+		std::is_same<Tp, float>::value || std::is_same<Tp, double>::value,
+		"Only float and double are supported");
+
+public:
+	typedef Tp value_type;
+	typedef typename std::conditional<sizeof(Tp) == 4, std::uint32_t, std::uint64_t>::type
+		bits_type;
+
+	enum {
+		value_bits = sizeof(Tp) * 8,
+		// Number of leading zeros is capped to fit this field
+		leading_bits = 5,
+		// Number of meaningful bits, value_bits is stored as 0
+		length_bits = sizeof(Tp) == 4 ? 5 : 6,
+	};
+
+	compressed_float_buffer()
+		: m_words()
+	{
+		reset();
+	}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Remove all values (memory is not actually overwritten).
+	 */
+	void reset()
+	{
+		m_bits = 0;
+		m_size = 0;
+		m_prev = 0;
+		m_leading = 0;
+		m_trailing = 0;
+	}
+
+	/**
+	 * Get the number of values.
+	 */
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	/**
+	 * Get the number of compressed bytes in use.
+	 */
+	std::size_t bytes() const noexcept
+	{
+		return (m_bits + 7) / 8;
+	}
+
+	static constexpr std::size_t max_bytes() noexcept
+	{
+		return Nm;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	void push_back(value_type v)
+	{
+		bits_type b;
+		std::memcpy(&b, &v, sizeof(b));
+
+		if(m_size == 0) {
+			check_space(value_bits);
+			put(b, value_bits);
+		} else {
+			const bits_type x = b ^ m_prev;
+
+			if(x == 0) {
+				check_space(1);
+				put(0, 1);
+			} else {
+				unsigned leading = count_leading(x);
+				const unsigned trailing = count_trailing(x);
+				if(leading > (1u << leading_bits) - 1u)
+					leading = (1u << leading_bits) - 1u;
+
+				// Before the first window is set, the (empty) window is 0/0, which
+				// would fit anything at full length; start a proper window instead.
+				if((m_leading | m_trailing) && leading >= m_leading
+				   && trailing >= m_trailing) {
+					// Fits within the previous window
+					const unsigned length = value_bits - m_leading - m_trailing;
+					check_space(2 + length);
+					put(1, 2); // Control bits '1', '0'
+					put(x >> m_trailing, length);
+				} else {
+					const unsigned length = value_bits - leading - trailing;
+					check_space(2 + leading_bits + length_bits + length);
+					put(3, 2); // Control bits '1', '1'
+					put(leading, leading_bits);
+					put(length == value_bits ? 0 : length, length_bits);
+					put(x >> trailing, length);
+					m_leading = leading;
+					m_trailing = trailing;
+				}
+			}
+		}
+
+		m_prev = b;
+		m_size++;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Call `f(value_type)` for every value, in order.
+	 */
+	template <typename F>
+	void for_each(F&& f) const
+	{
+		if(m_size == 0)
+			return;
+
+		std::size_t pos = 0;
+		bits_type prev = static_cast<bits_type>(get(pos, value_bits));
+		unsigned leading = 0;
+		unsigned trailing = 0;
+		f(to_value(prev));
+
+		for(std::size_t i = 1; i < m_size; i++) {
+			if(get(pos, 1)) {
+				if(get(pos, 1)) {
+					leading = static_cast<unsigned>(get(pos, leading_bits));
+					unsigned length =
+						static_cast<unsigned>(get(pos, length_bits));
+					if(length == 0)
+						length = value_bits;
+					trailing = value_bits - leading - length;
+				}
+				const unsigned length = value_bits - leading - trailing;
+				prev ^= static_cast<bits_type>(get(pos, length) << trailing);
+			}
+			f(to_value(prev));
+		}
+	}
+
+	/**
+	 * Decode all values, and append them to `out`.
+	 */
+	template <std::size_t N, typename Trace>
+	void decode(buffer<value_type, N, Trace>& out) const
+	{
+		if(out.free() < m_size) // Not enough space
+			std::__throw_out_of_range("compressed_float_buffer::decode");
+
+		value_type* p = out.data() + out.size();
+		for_each([&](value_type v) { *p++ = v; });
+		out.reset(out.size() + m_size);
+	}
+
+	/* @} */
+
+protected:
+	static unsigned count_leading(bits_type x) noexcept
+	{
+		return sizeof(bits_type) == 4 ? static_cast<unsigned>(__builtin_clz(x))
+					      : static_cast<unsigned>(__builtin_clzll(x));
+	}
+
+	static unsigned count_trailing(bits_type x) noexcept
+	{
+		return sizeof(bits_type) == 4 ? static_cast<unsigned>(__builtin_ctz(x))
+					      : static_cast<unsigned>(__builtin_ctzll(x));
+	}
+
+	static value_type to_value(bits_type b) noexcept
+	{
+		value_type v;
+		std::memcpy(&v, &b, sizeof(v));
+		return v;
+	}
+
+	void check_space(std::size_t bits) const
+	{
+		if(m_bits + bits > Nm * 8) // No space left
+			std::__throw_out_of_range("compressed_float_buffer::push_back");
+	}
+
+	/**
+	 * Store the lowest `n` bits of `v` at the end, for n <= 64.
+	 *
+	 * Bits beyond the end are overwritten, so storage never needs to be cleared.
+	 */
+	void put(std::uint64_t v, unsigned n) noexcept
+	{
+		v = detail::low_bits(v, n);
+		const std::size_t i = m_bits / 64;
+		const unsigned off = static_cast<unsigned>(m_bits % 64);
+
+		m_words[i] = detail::low_bits(m_words[i], off) | v << off;
+		if(off + n > 64)
+			m_words[i + 1] = v >> (64 - off);
+
+		m_bits += n;
+	}
+
+	/**
+	 * Load `n` bits at `pos`, for n <= 64, and advance `pos`.
+	 */
+	std::uint64_t get(std::size_t& pos, unsigned n) const noexcept
+	{
+		const std::size_t i = pos / 64;
+		const unsigned off = static_cast<unsigned>(pos % 64);
+
+		std::uint64_t v = m_words[i] >> off;
+		if(off + n > 64)
+			v |= m_words[i + 1] << (64 - off);
+
+		pos += n;
+		return detail::low_bits(v, n);
+	}
+
+	std::array<std::uint64_t, (Nm + 7) / 8> m_words;
+	std::size_t m_bits; // Number of bits used
+	std::size_t m_size; // Number of values
+	bits_type m_prev;   // Last value
+	unsigned m_leading; // Leading zeros of the current window
+	unsigned m_trailing; // Trailing zeros of the current window
+};
+
+} // namespace cc
+
+#endif /* COMPRESSED_FLOAT_BUFFER_H */
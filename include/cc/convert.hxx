@@ -0,0 +1,138 @@
+#ifndef CONVERT_H
+#define CONVERT_H
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+namespace cc {
+
+/**
+ * @defgroup Sample conversion kernels
+ *
+ * Converters for the converting `fifo::push_list()`, `fifo::pop_list()` and `buffer::append()`
+ * overloads. Each is called as `convert(const Src* src, Dst* dst, std::size_t n)` per contiguous
+ * segment, so the data is converted while it is copied, in a single pass.
+ *
+ * @code
+ * cc::fifo<float, 4096> samples;
+ * samples.push_list(pcm, pcm + n, cc::s16_to_float(1.0f / 32768.0f));
+ * @endcode
+ */
+/* @{ */
+
+/**
+ * Plain `static_cast` of each element.
+ */
+struct cast_convert {
+	template <typename Src, typename Dst>
+	void operator()(const Src* src, Dst* dst, std::size_t n) const
+	{
+		for(std::size_t i = 0; i < n; i++)
+			dst[i] = static_cast<Dst>(src[i]);
+	}
+};
+
+/**
+ * Signed 16-bit integers (like PCM or ADC codes) to float, multiplied by a scale.
+ */
+struct s16_to_float {
+	explicit s16_to_float(float scale = 1.0f)
+		: scale(scale)
+	{}
+
+	void operator()(const std::int16_t* src, float* dst, std::size_t n) const
+	{
+		std::size_t i = 0;
+#if defined(__AVX2__)
+		const __m256 s8 = _mm256_set1_ps(scale);
+		for(; i + 8 <= n; i += 8) {
+			const __m256i v = _mm256_cvtepi16_epi32(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+			_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s8));
+		}
+#endif
+#if defined(__SSE2__)
+		const __m128 s4 = _mm_set1_ps(scale);
+		for(; i + 8 <= n; i += 8) {
+			const __m128i v =
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			// Sign-extend by unpacking into the upper halves and shifting back
+			const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), s4));
+			_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s4));
+		}
+#endif
+		for(; i < n; i++)
+			dst[i] = static_cast<float>(src[i]) * scale;
+	}
+
+	float scale;
+};
+
+/**
+ * Float to signed 16-bit integers, multiplied by a scale, rounded to nearest and saturated.
+ *
+ * NaN becomes -32768.
+ */
+struct float_to_s16 {
+	explicit float_to_s16(float scale = 1.0f)
+		: scale(scale)
+	{}
+
+	void operator()(const float* src, std::int16_t* dst, std::size_t n) const
+	{
+		std::size_t i = 0;
+#if defined(__AVX2__)
+		const __m256 s8 = _mm256_set1_ps(scale);
+		const __m256 lo8 = _mm256_set1_ps(-32768.0f);
+		const __m256 hi8 = _mm256_set1_ps(32767.0f);
+		for(; i + 16 <= n; i += 16) {
+			// Clamp first; out of range conversions would give INT_MIN
+			const __m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), s8);
+			const __m256 b = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), s8);
+			const __m256 ca = _mm256_min_ps(_mm256_max_ps(a, lo8), hi8);
+			const __m256 cb = _mm256_min_ps(_mm256_max_ps(b, lo8), hi8);
+			// Pack per 128-bit lane, then put the lanes in order
+			const __m256i packed =
+				_mm256_packs_epi32(_mm256_cvtps_epi32(ca), _mm256_cvtps_epi32(cb));
+			_mm256_storeu_si256(
+				reinterpret_cast<__m256i*>(dst + i),
+				_mm256_permute4x64_epi64(packed, 0xD8));
+		}
+#endif
+#if defined(__SSE2__)
+		const __m128 s4 = _mm_set1_ps(scale);
+		const __m128 lo4 = _mm_set1_ps(-32768.0f);
+		const __m128 hi4 = _mm_set1_ps(32767.0f);
+		for(; i + 8 <= n; i += 8) {
+			const __m128 a = _mm_min_ps(
+				_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), s4), lo4), hi4);
+			const __m128 b = _mm_min_ps(
+				_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), s4), lo4), hi4);
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(dst + i),
+				_mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+		}
+#endif
+		for(; i < n; i++) {
+			float v = src[i] * scale;
+			// Same comparisons as maxps/minps, such that NaN ends up at the lower bound
+			v = v > -32768.0f ? v : -32768.0f;
+			v = v < 32767.0f ? v : 32767.0f;
+			dst[i] = static_cast<std::int16_t>(std::lrint(v));
+		}
+	}
+
+	float scale;
+};
+
+/* @} */
+
+} // namespace cc
+
+#endif /* CONVERT_H */
@@ -0,0 +1,312 @@
+#ifndef COUNT_MIN_H
+#define COUNT_MIN_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+#include "fifo.hxx"
+#include "hash.hxx"
+
+namespace cc {
+
+/**
+ * Count-min sketch: approximate counts of keys, in fixed memory.
+ *
+ * Each key increments one counter in each of the `D` rows of `W` counters. The estimate is the
+ * smallest of those, so it never undercounts, and overcounts by at most e/W of the total with
+ * probability 1 - e^-D.
+ *
+ * Row indices come from one 64-bit hash, split into two halves h1 and h2, as h1 + d * h2
+ * (Kirsch-Mitzenmacher). With AVX2, the indices of eight rows are computed at once, and
+ * estimate() gathers and takes the minimum of eight 32-bit counters at once.
+ *
+ * @tparam W Counters per row, a power of two
+ * @tparam D Number of rows
+ * @tparam Counter Unsigned counter type
+ */
+template <std::size_t W, std::size_t D, typename Counter = std::uint32_t>
+class count_min {
+	static_assert(W > 0 && (W & (W - 1)) == 0, "Width must be a power of two");
+	static_assert(D > 0, "Need at least one row");
+	static_assert(W * D <= 0x7FFFFFFF, "Counter index must fit in 31 bits");
+	static_assert(std::is_unsigned<Counter>::value, "Counters must be unsigned");
+
+public:
+	typedef Counter counter_type;
+
+	count_min()
+		: m_counters()
+		, m_total(0)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Set all counts to zero.
+	 */
+	void reset()
+	{
+		m_counters.fill(0);
+		m_total = 0;
+	}
+
+	/**
+	 * Get the sum of all counts added.
+	 */
+	counter_type total() const noexcept
+	{
+		return m_total;
+	}
+
+	static constexpr std::size_t width() noexcept
+	{
+		return W;
+	}
+
+	static constexpr std::size_t depth() noexcept
+	{
+		return D;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	template <typename Key>
+	void add(const Key& key, counter_type n = 1)
+	{
+		std::uint32_t idx[rows_padded];
+		indices(detail::sketch_hash(key), idx);
+		for(std::size_t d = 0; d < D; d++)
+			m_counters[idx[d]] += n;
+		m_total += n;
+	}
+
+	/**
+	 * Add all counts of another sketch, like adding all its keys again.
+	 */
+	void merge(const count_min& other)
+	{
+		for(std::size_t i = 0; i < W * D; i++)
+			m_counters[i] += other.m_counters[i];
+		m_total += other.m_total;
+	}
+
+	/**
+	 * Remove all counts of another sketch, whose keys must have been added to this one.
+	 */
+	void subtract(const count_min& other)
+	{
+		for(std::size_t i = 0; i < W * D; i++)
+			m_counters[i] -= other.m_counters[i];
+		m_total -= other.m_total;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get the estimated count of a key, which is at least its real count.
+	 */
+	template <typename Key>
+	counter_type estimate(const Key& key) const
+	{
+		std::uint32_t idx[rows_padded];
+		indices(detail::sketch_hash(key), idx);
+		std::size_t d = 0;
+		counter_type m = std::numeric_limits<counter_type>::max();
+
+#if defined(__AVX2__)
+		if constexpr(sizeof(counter_type) == 4) {
+			const int* base = reinterpret_cast<const int*>(m_counters.data());
+			const __m256i* vidx = reinterpret_cast<const __m256i*>(idx);
+			const __m256i depth = _mm256_set1_epi32(static_cast<int>(D));
+			const __m256i eight = _mm256_set1_epi32(8);
+			const __m256i ones = _mm256_set1_epi32(-1);
+			__m256i row = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			__m256i mv = ones;
+			for(; d < D; d += 8) {
+				// Lanes beyond D are not loaded, and keep the maximum
+				const __m256i valid = _mm256_cmpgt_epi32(depth, row);
+				const __m256i iv = _mm256_loadu_si256(vidx + d / 8);
+				const __m256i g =
+					_mm256_mask_i32gather_epi32(ones, base, iv, valid, 4);
+				mv = _mm256_min_epu32(mv, g);
+				row = _mm256_add_epi32(row, eight);
+			}
+			__m128i h = _mm_min_epu32(
+				_mm256_castsi256_si128(mv), _mm256_extracti128_si256(mv, 1));
+			h = _mm_min_epu32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2)));
+			h = _mm_min_epu32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1)));
+			m = static_cast<counter_type>(_mm_cvtsi128_si32(h));
+		}
+#endif
+		for(; d < D; d++)
+			m = std::min(m, m_counters[idx[d]]);
+		return m;
+	}
+
+	/* @} */
+
+protected:
+	// Rows rounded up to whole vectors, such that the index kernel needs no tail
+	static constexpr std::size_t rows_padded = (D + 7) / 8 * 8;
+
+	/**
+	 * Compute the counter index of each row for hash `h`.
+	 */
+	static void indices(std::uint64_t h, std::uint32_t* idx) noexcept
+	{
+		const std::uint32_t h1 = static_cast<std::uint32_t>(h);
+		const std::uint32_t h2 = static_cast<std::uint32_t>(h >> 32) | 1u; // Never zero
+#if defined(__AVX2__)
+		const __m256i mask = _mm256_set1_epi32(static_cast<int>(W - 1));
+		const __m256i v1 = _mm256_set1_epi32(static_cast<int>(h1));
+		const __m256i v2 = _mm256_set1_epi32(static_cast<int>(h2));
+		const __m256i width = _mm256_set1_epi32(static_cast<int>(W));
+		const __m256i eight = _mm256_set1_epi32(8);
+		__m256i row = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		for(std::size_t d = 0; d < rows_padded; d += 8) {
+			const __m256i g = _mm256_add_epi32(v1, _mm256_mullo_epi32(row, v2));
+			const __m256i off = _mm256_mullo_epi32(row, width);
+			const __m256i i = _mm256_add_epi32(_mm256_and_si256(g, mask), off);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(idx + d), i);
+			row = _mm256_add_epi32(row, eight);
+		}
+#else
+		for(std::size_t d = 0; d < D; d++)
+			idx[d] = ((h1 + static_cast<std::uint32_t>(d) * h2) & (W - 1))
+				 + static_cast<std::uint32_t>(d * W);
+#endif
+	}
+
+	std::array<counter_type, W * D> m_counters; // Row `d` is [d * W, (d + 1) * W)
+	counter_type m_total;
+};
+
+/**
+ * Count-min sketch over a sliding window of epochs.
+ *
+ * Counts are added to the current epoch, and estimates cover the last `Epochs` epochs. The
+ * sketch of each epoch is kept in a `cc::fifo`, next to their sum; advance() starts a new
+ * epoch, and when all are in use, subtracts the oldest from the sum. Memory is fixed at
+ * `Epochs + 1` sketches.
+ *
+ * @code
+ * cc::windowed_count_min<4096, 4, 60> per_source; // One minute, in seconds
+ * per_source.add(source_ip, bytes);
+ * if(second_elapsed)
+ *         per_source.advance();
+ * @endcode
+ */
+template <std::size_t W, std::size_t D, std::size_t Epochs, typename Counter = std::uint32_t>
+class windowed_count_min {
+public:
+	typedef count_min<W, D, Counter> sketch_type;
+	typedef Counter counter_type;
+
+	windowed_count_min()
+	{
+		m_epochs.push(sketch_type());
+	}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Forget all epochs, and start a new one.
+	 */
+	void reset()
+	{
+		m_total.reset();
+		m_epochs.truncate();
+		m_epochs.push(sketch_type());
+	}
+
+	/**
+	 * Get the number of epochs in the window, including the current one.
+	 */
+	std::size_t epochs() const noexcept
+	{
+		return m_epochs.size();
+	}
+
+	/**
+	 * Get the sum of all counts in the window.
+	 */
+	counter_type total() const noexcept
+	{
+		return m_total.total();
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	template <typename Key>
+	void add(const Key& key, counter_type n = 1)
+	{
+		m_total.add(key, n);
+		m_epochs.back().add(key, n);
+	}
+
+	/**
+	 * Start a new epoch, dropping the oldest when the window is full.
+	 */
+	void advance()
+	{
+		if(m_epochs.full()) {
+			m_total.subtract(m_epochs.front());
+			m_epochs.discard(1);
+		}
+		m_epochs.push(sketch_type());
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get the estimated count of a key over the window.
+	 */
+	template <typename Key>
+	counter_type estimate(const Key& key) const
+	{
+		return m_total.estimate(key);
+	}
+
+	/* @} */
+
+protected:
+	sketch_type m_total; // Sum of all epochs
+	fifo<sketch_type, Epochs, no_trace> m_epochs; // Internal, never traced
+};
+
+} // namespace cc
+
+#endif /* COUNT_MIN_H */
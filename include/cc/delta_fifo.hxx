@@ -0,0 +1,264 @@
+#ifndef DELTA_FIFO_H
+#define DELTA_FIFO_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "fifo.hxx"
+
+namespace cc {
+
+namespace detail {
+
+inline std::uint64_t zigzag_encode(std::int64_t v) noexcept
+{
+	return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+inline std::int64_t zigzag_decode(std::uint64_t v) noexcept
+{
+	return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1u);
+}
+
+/**
+ * Write `v` as LEB128 varint, 7 bits per byte.
+ *
+ * @return Number of bytes written, at most 10
+ */
+inline std::size_t varint_encode(std::uint64_t v, std::uint8_t* p) noexcept
+{
+	std::size_t n = 0;
+	for(; v >= 0x80u; v >>= 7)
+		p[n++] = static_cast<std::uint8_t>(v | 0x80u);
+	p[n++] = static_cast<std::uint8_t>(v);
+	return n;
+}
+
+inline std::uint64_t varint_decode(const std::uint8_t*& p) noexcept
+{
+	std::uint64_t v = 0;
+	for(unsigned shift = 0;; shift += 7) {
+		const std::uint8_t b = *p++;
+		v |= static_cast<std::uint64_t>(b & 0x7Fu) << shift;
+		if(!(b & 0x80u))
+			return v;
+	}
+}
+
+} // namespace detail
+
+/**
+ * Compressed fifo of integers that change slowly or at a steady rate, like timestamps.
+ *
+ * Values are stored in fixed-size blocks. The first value of a block is kept as is, the others
+ * as the zigzag varint of their delta-of-delta, so a steady rate takes one byte per value. Each
+ * push appends to the newest block, or starts a new one when it is full. Values are removed a
+ * whole block at a time with evict().
+ *
+ * Like `cc::fifo`, push() throws instead of overwriting old data. To keep a rolling history:
+ *
+ * @code
+ * if(history.full())
+ *         history.evict();
+ * history.push(timestamp);
+ * @endcode
+ *
+ * @tparam Tp Integral type of the values
+ * @tparam BlockBytes Size of the compressed data of each block
+ * @tparam Blocks Number of blocks
+ */
+template <typename Tp, std::size_t BlockBytes, std::size_t Blocks>
+class delta_fifo {
+	static_assert(std::is_integral<Tp>::value, "Only integers can be delta-encoded");
+	static_assert(sizeof(Tp) <= sizeof(std::uint64_t), "Type is too wide");
+	static_assert(BlockBytes >= 10, "Block must fit at least one varint");
+
+public:
+	typedef Tp value_type;
+
+	struct block {
+		Tp first;
+		std::uint64_t last;	  // Last value, two's complement
+		std::uint64_t last_delta; // Last delta, two's complement
+		std::size_t count;	  // Number of values, including `first`
+		std::size_t bytes;	  // Used part of `data`
+		std::array<std::uint8_t, BlockBytes> data;
+	};
+
+	delta_fifo()
+		: m_size(0)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Make the fifo empty.
+	 */
+	void truncate()
+	{
+		m_blocks.truncate();
+		m_size = 0;
+	}
+
+	/**
+	 * Get the number of values.
+	 */
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	/**
+	 * Get the number of blocks in use.
+	 */
+	std::size_t blocks() const noexcept
+	{
+		return m_blocks.size();
+	}
+
+	/**
+	 * Get the number of compressed bytes in use.
+	 */
+	std::size_t bytes() const noexcept
+	{
+		std::size_t n = 0;
+		for(auto const& b : m_blocks)
+			n += b.bytes;
+		return n;
+	}
+
+	/**
+	 * Returns true when all blocks are in use, so push() may need to evict() first.
+	 */
+	bool full() const noexcept
+	{
+		return m_blocks.full();
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	void push(const value_type& v)
+	{
+		const std::uint64_t u = static_cast<std::uint64_t>(v);
+
+		if(!m_blocks.empty()) {
+			block& b = m_blocks.back();
+			const std::uint64_t delta = u - b.last;
+			const std::uint64_t dod = delta - (b.count > 1 ? b.last_delta : 0);
+
+			std::uint8_t code[10];
+			const std::size_t n = detail::varint_encode(
+				detail::zigzag_encode(static_cast<std::int64_t>(dod)), code);
+
+			if(b.bytes + n <= BlockBytes) {
+				std::copy(code, code + n, b.data.data() + b.bytes);
+				b.bytes += n;
+				b.last = u;
+				b.last_delta = delta;
+				b.count++;
+				m_size++;
+				return;
+			}
+		}
+
+		if(m_blocks.full())
+			std::__throw_out_of_range("delta_fifo::push"); // No space left
+
+		m_blocks.push(block());
+		block& b = m_blocks.back();
+		b.first = v;
+		b.last = u;
+		b.last_delta = 0;
+		b.count = 1;
+		b.bytes = 0;
+		m_size++;
+	}
+
+	/**
+	 * Remove the oldest block.
+	 *
+	 * @return Number of values removed
+	 */
+	std::size_t evict()
+	{
+		if(m_blocks.empty())
+			std::__throw_out_of_range("delta_fifo::evict"); // No items left
+
+		const std::size_t n = m_blocks.front().count;
+		m_blocks.discard(1);
+		m_size -= n;
+		return n;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get the newest value.
+	 */
+	value_type back() const
+	{
+		return static_cast<value_type>(m_blocks.back().last);
+	}
+
+	/**
+	 * Call `f(value_type)` for every value, from the oldest to the newest.
+	 */
+	template <typename F>
+	void for_each(F&& f) const
+	{
+		for(auto const& b : m_blocks) {
+			std::uint64_t u = static_cast<std::uint64_t>(b.first);
+			std::uint64_t delta = 0;
+			f(b.first);
+
+			const std::uint8_t* p = b.data.data();
+			for(std::size_t i = 1; i < b.count; i++) {
+				delta += static_cast<std::uint64_t>(
+					detail::zigzag_decode(detail::varint_decode(p)));
+				u += delta;
+				f(static_cast<value_type>(u));
+			}
+		}
+	}
+
+	/**
+	 * Decode all values to `out`, which must have room for size() values.
+	 *
+	 * @return Pointer past the last value written
+	 */
+	value_type* copy(value_type* out) const
+	{
+		for_each([&](value_type v) { *out++ = v; });
+		return out;
+	}
+
+	/* @} */
+
+protected:
+	fifo<block, Blocks, no_trace> m_blocks; // Internal, never traced
+	std::size_t m_size;
+};
+
+} // namespace cc
+
+#endif /* DELTA_FIFO_H */
@@ -2,6 +2,9 @@
 #define FIFO_H
 
 #include <array>
+#include <iterator>
+
+#include "trace.hxx"
 
 /**
  * Mimics std::, but 'custom'.
@@ -15,12 +18,72 @@ namespace cc {
  *
  * @tparam Tp Type of each element
  * @tparam Nm Number of items that fit in the fifo until full
+ * @tparam Trace Policy that receives push and pop events, see trace.hxx
  */
-template <typename Tp, std::size_t Nm>
+template <typename Tp, std::size_t Nm, typename Trace = CC_TRACE_POLICY>
 class fifo : public std::array<Tp, Nm> {
 public:
 	typedef Tp value_type;
 
+	/**
+	 * Forward iterator over the used elements, from the oldest to the newest.
+	 */
+	template <typename Vp>
+	class basic_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Tp value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef Vp* pointer;
+		typedef Vp& reference;
+
+		basic_iterator(pointer base, std::size_t index)
+			: m_base(base)
+			, m_index(index)
+		{}
+
+		reference operator*() const
+		{
+			// The index runs from the tail up to the head, which can exceed Nm once
+			return m_base[m_index < Nm ? m_index : m_index - Nm];
+		}
+
+		pointer operator->() const
+		{
+			return &operator*();
+		}
+
+		basic_iterator& operator++()
+		{
+			m_index++;
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			basic_iterator it = *this;
+			m_index++;
+			return it;
+		}
+
+		bool operator==(const basic_iterator& other) const
+		{
+			return m_index == other.m_index;
+		}
+
+		bool operator!=(const basic_iterator& other) const
+		{
+			return m_index != other.m_index;
+		}
+
+	private:
+		pointer m_base;
+		std::size_t m_index;
+	};
+
+	typedef basic_iterator<value_type> iterator;
+	typedef basic_iterator<const value_type> const_iterator;
+
 	fifo()
 		: m_head(0)
 		, m_tail(0)
@@ -36,8 +99,11 @@ public:
 	 */
 	void truncate()
 	{
+		const std::size_t n = size();
 		m_tail = 0;
 		m_head = 0;
+		if(n)
+			trace_pop(n);
 	}
 
 	/**
@@ -71,6 +137,47 @@ public:
 
 	/* @} */
 
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get the oldest element, which is the next to be popped.
+	 */
+	value_type& front()
+	{
+		if(empty())
+			std::__throw_out_of_range("fifo::front");
+		return this->operator[](m_tail);
+	}
+
+	const value_type& front() const
+	{
+		if(empty())
+			std::__throw_out_of_range("fifo::front");
+		return this->operator[](m_tail);
+	}
+
+	/**
+	 * Get the newest element, which was pushed last.
+	 */
+	value_type& back()
+	{
+		if(empty())
+			std::__throw_out_of_range("fifo::back");
+		return this->operator[]((m_head - 1) % this->max_size());
+	}
+
+	const value_type& back() const
+	{
+		if(empty())
+			std::__throw_out_of_range("fifo::back");
+		return this->operator[]((m_head - 1) % this->max_size());
+	}
+
+	/* @} */
+
 	/**
 	 * @defgroup Modifying element access
 	 */
@@ -85,6 +192,7 @@ public:
 		// `m_head` can actually exceed max_size
 		m_head++;
 		// Don't modulo, only do that on tail updates
+		trace_push(1);
 	}
 
 	value_type pop()
@@ -94,6 +202,7 @@ public:
 
 		const auto v = this->operator[](m_tail);
 		increment_tail();
+		trace_pop(1);
 		return v;
 	}
 
@@ -115,6 +224,7 @@ public:
 		const std::size_t n2 = n - n1;
 		std::copy(other_begin + n1, other_begin + n, this->data());
 		m_head += n; // Don't modulo, do that in pop_*
+		trace_push(n);
 	}
 
 	/**
@@ -136,21 +246,151 @@ public:
 		const std::size_t n2 = n - n1;
 		std::copy(this->data(), this->data() + n2, other_begin + n1);
 		increment_tail(n);
+		trace_pop(n);
+	}
+
+	/**
+	 * Add multiple elements of another type, converting them on the way in.
+	 *
+	 * `convert(const Src* src, value_type* dst, std::size_t n)` is called once per segment, so
+	 * it can be a vectorized kernel; see convert.hxx.
+	 */
+	template <typename Src, typename Convert>
+	void push_list(const Src* other_begin, const Src* other_end, Convert&& convert)
+	{
+		const std::size_t n = other_end - other_begin;
+		if(free() < n)
+			std::__throw_out_of_range("fifo::push_list"); // Not enough space left
+
+		// Convert elements until the end of the buffer:
+		const std::size_t n1 = std::min(n, this->max_size() - head_modulo());
+		convert(other_begin, this->data() + head_modulo(), n1);
+		// Convert elements to the start of the buffer:
+		convert(other_begin + n1, this->data(), n - n1);
+		m_head += n; // Don't modulo, do that in pop_*
+		trace_push(n);
+	}
+
+	/**
+	 * Remove multiple elements from the queue, converting them on the way out.
+	 *
+	 * `convert(const value_type* src, Dst* dst, std::size_t n)` is called once per segment.
+	 *
+	 * @param n Number of items - 0: take all available items
+	 */
+	template <typename Dst, typename Convert>
+	void pop_list(Dst* other_begin, std::size_t n, Convert&& convert)
+	{
+		if(n > size())
+			std::__throw_out_of_range("fifo::pop_list"); // Not enough items left
+		else if(n == 0)
+			n = size();
+
+		// Convert elements until the end of the buffer:
+		const std::size_t n1 = std::min(n, this->max_size() - m_tail);
+		convert(this->data() + m_tail, other_begin, n1);
+		// Convert elements from the start of the buffer:
+		convert(this->data(), other_begin + n1, n - n1);
+		increment_tail(n);
+		trace_pop(n);
+	}
+
+	/**
+	 * Remove the `n` oldest elements, without copying them anywhere.
+	 */
+	void discard(std::size_t n)
+	{
+		if(n > size())
+			std::__throw_out_of_range("fifo::discard"); // Not enough items left
+		increment_tail(n);
+		trace_pop(n);
 	}
 
 	/* }@ */
 
+	/**
+	 * @defgroup Segment access
+	 *
+	 * The used elements occupy at most two contiguous segments of the underlying array: the
+	 * first runs from the tail towards the end of the array, the second continues at the start
+	 * of the array. Use these to process the contents in place, without popping them.
+	 */
+	/* @{ */
+
+	const value_type* first_segment() const noexcept
+	{
+		return this->data() + m_tail;
+	}
+
+	std::size_t first_segment_size() const noexcept
+	{
+		return std::min(size(), this->max_size() - m_tail);
+	}
+
+	const value_type* second_segment() const noexcept
+	{
+		return this->data();
+	}
+
+	std::size_t second_segment_size() const noexcept
+	{
+		return size() - first_segment_size();
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Iterator
+	 */
+	/* @{ */
+
 	iterator begin() noexcept
 	{
-		return iterator(this->data() + head_modulo());
+		return iterator(this->data(), m_tail);
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return const_iterator(this->data(), m_tail);
 	}
 
 	iterator end() noexcept
 	{
-		return iterator(this->data() + m_tail);
+		return iterator(this->data(), m_head);
+	}
+
+	const_iterator end() const noexcept
+	{
+		return const_iterator(this->data(), m_head);
 	}
 
+	/* @} */
+
 protected:
+	/**
+	 * Report `n` added elements to the trace policy.
+	 */
+	void trace_push(std::size_t n) const
+	{
+		if constexpr(Trace::enabled) {
+			Trace::push("fifo", this, n, size());
+			if(full())
+				Trace::full("fifo", this, size());
+		}
+	}
+
+	/**
+	 * Report `n` removed elements to the trace policy.
+	 */
+	void trace_pop(std::size_t n) const
+	{
+		if constexpr(Trace::enabled) {
+			Trace::pop("fifo", this, n, size());
+			if(empty())
+				Trace::empty("fifo", this);
+		}
+	}
+
 	void increment_tail(std::size_t incr = 1)
 	{
 		m_tail += incr;
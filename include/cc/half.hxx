@@ -0,0 +1,311 @@
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__AVX2__) || defined(__AVX512F__)
+#	include <immintrin.h>
+#endif
+
+#include "buffer.hxx"
+#include "fifo.hxx"
+
+namespace cc {
+
+namespace detail {
+
+inline std::uint32_t float_bits(float f) noexcept
+{
+	std::uint32_t x;
+	std::memcpy(&x, &f, sizeof(x));
+	return x;
+}
+
+inline float bits_float(std::uint32_t x) noexcept
+{
+	float f;
+	std::memcpy(&f, &x, sizeof(f));
+	return f;
+}
+
+} // namespace detail
+
+/**
+ * IEEE 754 half-precision (binary16) storage type.
+ *
+ * Only meant for storage: it converts implicitly to and from `float`, rounding to nearest even.
+ * Use the bulk convert() functions for arrays.
+ */
+struct float16 {
+	std::uint16_t bits;
+
+	float16() = default;
+
+	float16(float f) noexcept
+		: bits(from_float(f))
+	{}
+
+	operator float() const noexcept
+	{
+		return to_float(bits);
+	}
+
+	static std::uint16_t from_float(float f) noexcept
+	{
+#if defined(__F16C__)
+		return static_cast<std::uint16_t>(_cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT));
+#else
+		const std::uint32_t f32infty = 255u << 23;
+		const std::uint32_t f16max = (127u + 16u) << 23;
+		const std::uint32_t denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		std::uint32_t x = detail::float_bits(f);
+		const std::uint32_t sign = x & 0x80000000u;
+		x ^= sign;
+
+		std::uint32_t h;
+		if(x >= f16max) {
+			h = x > f32infty ? 0x7E00u : 0x7C00u; // NaN or overflow to Inf
+		} else if(x < (113u << 23)) {
+			// Subnormal or zero: let the FPU do the rounding
+			const float magic = detail::bits_float(denorm_magic);
+			h = detail::float_bits(detail::bits_float(x) + magic) - denorm_magic;
+		} else {
+			const std::uint32_t odd = (x >> 13) & 1u;
+			x += ((15u - 127u) << 23) + 0xFFFu + odd;
+			h = x >> 13;
+		}
+		return static_cast<std::uint16_t>(h | sign >> 16);
+#endif
+	}
+
+	static float to_float(std::uint16_t h) noexcept
+	{
+#if defined(__F16C__)
+		return _cvtsh_ss(h);
+#else
+		const std::uint32_t shifted_exp = 0x7C00u << 13;
+		std::uint32_t x = (h & 0x7FFFu) << 13;
+		const std::uint32_t exp = x & shifted_exp;
+
+		x += (127u - 15u) << 23;
+		if(exp == shifted_exp) {
+			x += (128u - 16u) << 23; // Inf or NaN
+		} else if(exp == 0) {
+			// Subnormal or zero: renormalize
+			x += 1u << 23;
+			const float magic = detail::bits_float(113u << 23);
+			x = detail::float_bits(detail::bits_float(x) - magic);
+		}
+		return detail::bits_float(x | static_cast<std::uint32_t>(h & 0x8000u) << 16);
+#endif
+	}
+};
+
+/**
+ * bfloat16 storage type: the upper half of a `float`.
+ *
+ * Same range as `float`, but only 8 bits of precision. Conversion from `float` rounds to nearest
+ * even.
+ */
+struct bfloat16 {
+	std::uint16_t bits;
+
+	bfloat16() = default;
+
+	bfloat16(float f) noexcept
+		: bits(from_float(f))
+	{}
+
+	operator float() const noexcept
+	{
+		return to_float(bits);
+	}
+
+	static std::uint16_t from_float(float f) noexcept
+	{
+		const std::uint32_t x = detail::float_bits(f);
+		if((x & 0x7FFFFFFFu) > 0x7F800000u)
+			return static_cast<std::uint16_t>((x | 0x00400000u) >> 16); // Quiet NaN
+		return static_cast<std::uint16_t>((x + 0x7FFFu + ((x >> 16) & 1u)) >> 16);
+	}
+
+	static float to_float(std::uint16_t b) noexcept
+	{
+		return detail::bits_float(static_cast<std::uint32_t>(b) << 16);
+	}
+};
+
+static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2, "Unexpected padding");
+
+/**
+ * @defgroup Bulk conversion
+ *
+ * Convert `n` elements from `src` to `dst`. These use F16C or AVX-512F for float16, and AVX2 for
+ * bfloat16 when the target supports it, with the same results as the scalar conversions.
+ */
+/* @{ */
+
+inline void convert(const float* src, float16* dst, std::size_t n)
+{
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	for(; i + 16 <= n; i += 16)
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i*>(dst + i),
+			_mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+#if defined(__F16C__)
+	for(; i + 8 <= n; i += 8)
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(dst + i),
+			_mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+	for(; i < n; i++)
+		dst[i] = float16(src[i]);
+}
+
+inline void convert(const float16* src, float* dst, std::size_t n)
+{
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	for(; i + 16 <= n; i += 16)
+		_mm512_storeu_ps(
+			dst + i,
+			_mm512_cvtph_ps(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+#endif
+#if defined(__F16C__)
+	for(; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(
+			dst + i,
+			_mm256_cvtph_ps(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+#endif
+	for(; i < n; i++)
+		dst[i] = src[i];
+}
+
+inline void convert(const float* src, bfloat16* dst, std::size_t n)
+{
+	std::size_t i = 0;
+#if defined(__AVX2__)
+	const __m256i abs_mask = _mm256_set1_epi32(0x7FFFFFFF);
+	const __m256i infinity = _mm256_set1_epi32(0x7F800000);
+	const __m256i quiet = _mm256_set1_epi32(0x00400000);
+	const __m256i round = _mm256_set1_epi32(0x7FFF);
+	const __m256i one = _mm256_set1_epi32(1);
+
+	for(; i + 8 <= n; i += 8) {
+		const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), one);
+		const __m256i rounded = _mm256_add_epi32(_mm256_add_epi32(x, round), odd);
+		const __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(x, abs_mask), infinity);
+		const __m256i v = _mm256_srli_epi32(
+			_mm256_blendv_epi8(rounded, _mm256_or_si256(x, quiet), nan), 16);
+		// Pack per 128-bit lane, then put the lanes in order
+		const __m256i packed =
+			_mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), 0x08); // 0, 2, x, x
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+	}
+#endif
+	for(; i < n; i++)
+		dst[i] = bfloat16(src[i]);
+}
+
+inline void convert(const bfloat16* src, float* dst, std::size_t n)
+{
+	std::size_t i = 0;
+#if defined(__AVX2__)
+	for(; i + 8 <= n; i += 8) {
+		const __m256i x = _mm256_cvtepu16_epi32(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_slli_epi32(x, 16));
+	}
+#endif
+	for(; i < n; i++)
+		dst[i] = src[i];
+}
+
+/* @} */
+
+namespace detail {
+
+template <typename Tp>
+struct is_half : std::false_type {};
+template <>
+struct is_half<float16> : std::true_type {};
+template <>
+struct is_half<bfloat16> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * Converter for the converting `fifo::push_list()`, `fifo::pop_list()` and `buffer::append()`
+ * overloads, using the bulk convert() functions above.
+ */
+struct half_convert {
+	template <typename Src, typename Dst>
+	void operator()(const Src* src, Dst* dst, std::size_t n) const
+	{
+		convert(src, dst, n);
+	}
+};
+
+/**
+ * @defgroup Float access to half-precision containers
+ *
+ * Element access converts implicitly, these are for whole arrays.
+ */
+/* @{ */
+
+/**
+ * Append floats to a float16/bfloat16 buffer.
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+typename std::enable_if<detail::is_half<Tp>::value>::type
+append(buffer<Tp, Nm, Trace>& b, const float* first, const float* last)
+{
+	b.append(first, last, half_convert());
+}
+
+/**
+ * Copy the used elements of a float16/bfloat16 buffer to floats.
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+typename std::enable_if<detail::is_half<Tp>::value>::type
+copy(const buffer<Tp, Nm, Trace>& b, float* out)
+{
+	convert(b.data(), out, b.size());
+}
+
+/**
+ * Push floats into a float16/bfloat16 fifo.
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+typename std::enable_if<detail::is_half<Tp>::value>::type
+push_list(fifo<Tp, Nm, Trace>& f, const float* first, const float* last)
+{
+	f.push_list(first, last, half_convert());
+}
+
+/**
+ * Pop from a float16/bfloat16 fifo as floats.
+ *
+ * @param n Number of items - Default: take all available items
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+typename std::enable_if<detail::is_half<Tp>::value>::type
+pop_list(fifo<Tp, Nm, Trace>& f, float* out, std::size_t n = 0)
+{
+	f.pop_list(out, n, half_convert());
+}
+
+/* @} */
+
+} // namespace cc
+
+#endif /* HALF_H */
@@ -0,0 +1,41 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Finalizer of splitmix64, to spread the bits of weak hashes (like std::hash of integers).
+ */
+inline std::uint64_t mix64(std::uint64_t x) noexcept
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9u;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBu;
+	x ^= x >> 31;
+	return x;
+}
+
+/**
+ * Hash of a key for the sketches: integers directly, other types through `std::hash`.
+ */
+template <typename Key>
+inline std::uint64_t sketch_hash(const Key& key) noexcept
+{
+	if constexpr(std::is_integral<Key>::value || std::is_enum<Key>::value)
+		return mix64(static_cast<std::uint64_t>(key));
+	else
+		return mix64(static_cast<std::uint64_t>(std::hash<Key>()(key)));
+}
+
+} // namespace detail
+
+} // namespace cc
+
+#endif /* HASH_H */
@@ -0,0 +1,260 @@
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Magnitude of half the number of sub-buckets, such that neighbouring values within a bucket
+ * differ by at most 1 in 10^digits.
+ */
+constexpr unsigned hdr_half_magnitude(unsigned digits) noexcept
+{
+	std::uint64_t largest = 2;
+	for(unsigned i = 0; i < digits; i++)
+		largest *= 10; // Sub-buckets needed for that resolution
+	unsigned magnitude = 0;
+	while((std::uint64_t(1) << magnitude) < largest)
+		magnitude++;
+	return magnitude - 1;
+}
+
+/**
+ * Number of buckets, each twice as wide as the previous, needed to reach `max`.
+ */
+constexpr std::size_t hdr_bucket_count(std::uint64_t max, std::uint64_t sub_buckets) noexcept
+{
+	std::size_t n = 1;
+	std::uint64_t untrackable = sub_buckets; // Smallest value above the first n buckets
+	while(untrackable <= max && n < 64) {
+		untrackable <<= 1;
+		n++;
+	}
+	return n;
+}
+
+} // namespace detail
+
+/**
+ * Histogram of values from 0 to `MaxValue`, with `SigDigits` significant decimal digits of
+ * resolution at any magnitude, in a flat array (HdrHistogram's log-linear layout).
+ *
+ * Values are grouped in buckets that double in width, each split into the same number of linear
+ * sub-buckets. Recording is a count-leading-zeros, a shift and an increment, without branches.
+ * Percentile queries scan the counts once, and are accurate to 1 in 10^SigDigits.
+ *
+ * Only the range of counts in use is scanned by queries and cleared by reset(), so both stay
+ * cheap when the values cluster, as latencies do.
+ *
+ * @code
+ * cc::hdr_histogram<60000000000, 3> latency; // Up to a minute in ns, to 0.1%
+ * latency.record(t1 - t0);
+ * report(latency.value_at_percentile(99.9));
+ * @endcode
+ *
+ * @tparam MaxValue Largest value tracked; larger ones are recorded as MaxValue
+ * @tparam SigDigits Significant decimal digits, 1 to 5
+ */
+template <std::uint64_t MaxValue, unsigned SigDigits = 3>
+class hdr_histogram {
+	static_assert(MaxValue >= 2, "Need a range to track");
+	static_assert(SigDigits >= 1 && SigDigits <= 5, "Need 1 to 5 significant digits");
+
+	static constexpr unsigned half_magnitude = detail::hdr_half_magnitude(SigDigits);
+	static constexpr std::uint64_t half_count = std::uint64_t(1) << half_magnitude;
+	static constexpr std::uint64_t sub_bucket_mask = 2 * half_count - 1;
+	static constexpr std::size_t bucket_count =
+		detail::hdr_bucket_count(MaxValue, 2 * half_count);
+	static constexpr std::size_t counts_size = (bucket_count + 1) * half_count;
+
+public:
+	hdr_histogram()
+		: m_counts()
+		, m_total(0)
+		, m_min(~std::uint64_t(0))
+		, m_max(0)
+		, m_lowest(counts_size)
+		, m_highest(0)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Forget all values. Only the counts in use are cleared.
+	 */
+	void reset()
+	{
+		if(m_total)
+			std::fill(m_counts.begin() + m_lowest, m_counts.begin() + m_highest + 1, 0);
+		m_total = 0;
+		m_min = ~std::uint64_t(0);
+		m_max = 0;
+		m_lowest = counts_size;
+		m_highest = 0;
+	}
+
+	/**
+	 * Get the number of values recorded.
+	 */
+	std::uint64_t count() const noexcept
+	{
+		return m_total;
+	}
+
+	/**
+	 * Get the number of counters, which is fixed by the template arguments.
+	 */
+	static constexpr std::size_t buckets() noexcept
+	{
+		return counts_size;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	/**
+	 * Record `n` occurrences of value `v`.
+	 */
+	void record(std::uint64_t v, std::uint64_t n = 1) noexcept
+	{
+		v = std::min(v, MaxValue);
+		const std::size_t i = index(v);
+		m_counts[i] += n;
+		m_total += n;
+		m_min = std::min(m_min, v);
+		m_max = std::max(m_max, v);
+		m_lowest = std::min(m_lowest, i);
+		m_highest = std::max(m_highest, i);
+	}
+
+	/**
+	 * Add all values of another histogram, like one per thread into a total.
+	 */
+	void merge(const hdr_histogram& other) noexcept
+	{
+		if(!other.m_total)
+			return;
+		for(std::size_t i = other.m_lowest; i <= other.m_highest; i++)
+			m_counts[i] += other.m_counts[i];
+		m_total += other.m_total;
+		m_min = std::min(m_min, other.m_min);
+		m_max = std::max(m_max, other.m_max);
+		m_lowest = std::min(m_lowest, other.m_lowest);
+		m_highest = std::max(m_highest, other.m_highest);
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	std::uint64_t min() const
+	{
+		if(!m_total)
+			std::__throw_out_of_range("hdr_histogram::min");
+		return m_min;
+	}
+
+	std::uint64_t max() const
+	{
+		if(!m_total)
+			std::__throw_out_of_range("hdr_histogram::max");
+		return m_max;
+	}
+
+	double mean() const
+	{
+		if(!m_total)
+			std::__throw_out_of_range("hdr_histogram::mean");
+		double sum = 0;
+		for(std::size_t i = m_lowest; i <= m_highest; i++)
+			sum += static_cast<double>(m_counts[i]) * static_cast<double>(median_of(i));
+		return sum / static_cast<double>(m_total);
+	}
+
+	/**
+	 * Get the value below or at which `p` percent (0 to 100) of the values are, to the
+	 * resolution of the histogram. `p` is clamped to that range, and NaN taken as 0.
+	 */
+	std::uint64_t value_at_percentile(double p) const
+	{
+		if(!m_total)
+			std::__throw_out_of_range("hdr_histogram::value_at_percentile");
+		p = p > 0 ? std::min(p, 100.0) : 0; // Also catches NaN
+		const double wanted = p / 100 * static_cast<double>(m_total) + 0.5;
+		const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(wanted));
+		std::uint64_t seen = 0;
+		for(std::size_t i = m_lowest; i <= m_highest; i++) {
+			seen += m_counts[i];
+			if(seen >= rank)
+				return std::min(highest_of(i), m_max);
+		}
+		return m_max;
+	}
+
+	/**
+	 * Get the number of values recorded that are equivalent to `v` at this resolution.
+	 */
+	std::uint64_t count_at(std::uint64_t v) const noexcept
+	{
+		return m_counts[index(std::min(v, MaxValue))];
+	}
+
+	/* @} */
+
+protected:
+	static std::size_t index(std::uint64_t v) noexcept
+	{
+		// Values below 2 * half_count land in bucket 0, which is linear from 0
+		const std::uint64_t top = v | sub_bucket_mask;
+		const unsigned log2 = 63 - static_cast<unsigned>(__builtin_clzll(top));
+		const unsigned bucket = log2 - half_magnitude;
+		// Sub-buckets below half_count are covered by the previous bucket, at a finer width
+		const std::uint64_t first = std::uint64_t(bucket + 1) << half_magnitude;
+		return static_cast<std::size_t>(first + (v >> bucket) - half_count);
+	}
+
+	static std::uint64_t lowest_of(std::size_t i) noexcept
+	{
+		const std::size_t b = i >> half_magnitude;
+		const std::uint64_t sub = (i & (half_count - 1)) + (b ? half_count : 0);
+		return sub << (b ? b - 1 : 0);
+	}
+
+	static std::uint64_t highest_of(std::size_t i) noexcept
+	{
+		const std::size_t b = i >> half_magnitude;
+		return lowest_of(i) + (std::uint64_t(1) << (b ? b - 1 : 0)) - 1;
+	}
+
+	static std::uint64_t median_of(std::size_t i) noexcept
+	{
+		return lowest_of(i) + (highest_of(i) - lowest_of(i)) / 2;
+	}
+
+	std::array<std::uint64_t, counts_size> m_counts;
+	std::uint64_t m_total;
+	std::uint64_t m_min;
+	std::uint64_t m_max;
+	std::size_t m_lowest; // Range of counts in use, for reset() and the queries
+	std::size_t m_highest;
+};
+
+} // namespace cc
+
+#endif /* HDR_HISTOGRAM_H */
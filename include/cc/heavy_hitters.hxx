@@ -0,0 +1,163 @@
+#ifndef HEAVY_HITTERS_H
+#define HEAVY_HITTERS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "buffer.hxx"
+
+namespace cc {
+
+/**
+ * Most frequent keys of a stream, with the Space-Saving algorithm, in fixed memory.
+ *
+ * Tracks at most `K` keys. A key that is not tracked replaces the one with the lowest count,
+ * and inherits that count as its error. So every key with a real count above total() / K is
+ * guaranteed to be tracked, and each count overestimates by at most its error().
+ *
+ * Keys and counts are stored in flat arrays, which are scanned linearly: meant for K up to a
+ * few hundred.
+ *
+ * @tparam Key Type of the keys, compared with `==`
+ * @tparam K Number of keys tracked
+ * @tparam Counter Unsigned counter type
+ */
+template <typename Key, std::size_t K, typename Counter = std::uint64_t>
+class heavy_hitters {
+	static_assert(K > 0, "Need to track at least one key");
+
+public:
+	typedef Key key_type;
+	typedef Counter counter_type;
+
+	struct entry {
+		Key key;
+		Counter count; // Estimated count, never less than the real count
+		Counter error; // Maximum overestimation of `count`
+	};
+
+	heavy_hitters()
+		: m_keys()
+		, m_counts()
+		, m_errors()
+		, m_size(0)
+		, m_total(0)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Forget all keys.
+	 */
+	void reset()
+	{
+		m_size = 0;
+		m_total = 0;
+	}
+
+	/**
+	 * Get the number of keys tracked.
+	 */
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return K;
+	}
+
+	/**
+	 * Get the sum of all counts added.
+	 */
+	counter_type total() const noexcept
+	{
+		return m_total;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	void add(const key_type& key, counter_type n = 1)
+	{
+		m_total += n;
+
+		const std::size_t i = find(key);
+		if(i < m_size) {
+			m_counts[i] += n;
+		} else if(m_size < K) {
+			m_keys[m_size] = key;
+			m_counts[m_size] = n;
+			m_errors[m_size] = 0;
+			m_size++;
+		} else {
+			const auto min = std::min_element(m_counts.begin(), m_counts.end());
+			const std::size_t j = static_cast<std::size_t>(min - m_counts.begin());
+			m_keys[j] = key;
+			m_errors[j] = m_counts[j];
+			m_counts[j] += n;
+		}
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get the estimated count of a key, or zero if it is not tracked.
+	 */
+	counter_type count(const key_type& key) const
+	{
+		const std::size_t i = find(key);
+		return i < m_size ? m_counts[i] : 0;
+	}
+
+	/**
+	 * Get the tracked keys, from the highest count to the lowest.
+	 */
+	buffer<entry, K, no_trace> sorted() const
+	{
+		buffer<entry, K, no_trace> out;
+		for(std::size_t i = 0; i < m_size; i++)
+			out.push_back(entry{m_keys[i], m_counts[i], m_errors[i]});
+		std::stable_sort(out.begin(), out.end(), [](const entry& a, const entry& b) {
+			return a.count > b.count;
+		});
+		return out;
+	}
+
+	/* @} */
+
+protected:
+	/**
+	 * Get the index of a key, or size() if it is not tracked.
+	 */
+	std::size_t find(const key_type& key) const
+	{
+		return static_cast<std::size_t>(
+			std::find(m_keys.begin(), m_keys.begin() + m_size, key) - m_keys.begin());
+	}
+
+	// Separate arrays, such that the key search and the minimum count search are dense scans
+	std::array<Key, K> m_keys;
+	std::array<Counter, K> m_counts;
+	std::array<Counter, K> m_errors;
+	std::size_t m_size;
+	Counter m_total;
+};
+
+} // namespace cc
+
+#endif /* HEAVY_HITTERS_H */
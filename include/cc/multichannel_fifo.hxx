@@ -0,0 +1,388 @@
+#ifndef MULTICHANNEL_FIFO_H
+#define MULTICHANNEL_FIFO_H
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#	include <immintrin.h>
+#endif
+
+namespace cc {
+
+namespace detail {
+
+#if defined(__SSE2__)
+/**
+ * Transpose a square block of 16 bytes per row: 4x4 of 32-bit or 8x8 of 16-bit elements.
+ *
+ * Row `i` is read from `src + i * src_stride` and column `i` is written to
+ * `dst + i * dst_stride`.
+ */
+template <typename Tp>
+inline void transpose_block(
+	const Tp* src, std::size_t src_stride, Tp* dst, std::size_t dst_stride) noexcept
+{
+	static_assert(sizeof(Tp) == 2 || sizeof(Tp) == 4, "Only 16 and 32-bit types");
+	constexpr std::size_t L = 16 / sizeof(Tp);
+
+	__m128i r[L];
+	for(std::size_t i = 0; i < L; i++)
+		r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * src_stride));
+
+	if constexpr(sizeof(Tp) == 4) {
+		const __m128i a0 = _mm_unpacklo_epi32(r[0], r[1]);
+		const __m128i a1 = _mm_unpacklo_epi32(r[2], r[3]);
+		const __m128i a2 = _mm_unpackhi_epi32(r[0], r[1]);
+		const __m128i a3 = _mm_unpackhi_epi32(r[2], r[3]);
+		r[0] = _mm_unpacklo_epi64(a0, a1);
+		r[1] = _mm_unpackhi_epi64(a0, a1);
+		r[2] = _mm_unpacklo_epi64(a2, a3);
+		r[3] = _mm_unpackhi_epi64(a2, a3);
+	} else {
+		__m128i a[8], b[8];
+		for(std::size_t i = 0; i < 8; i += 2) {
+			a[i / 2] = _mm_unpacklo_epi16(r[i], r[i + 1]);
+			a[i / 2 + 4] = _mm_unpackhi_epi16(r[i], r[i + 1]);
+		}
+		// a[0..3] hold columns 0-3 of row pairs, a[4..7] columns 4-7
+		for(std::size_t i = 0; i < 8; i += 4) {
+			b[i] = _mm_unpacklo_epi32(a[i], a[i + 1]);
+			b[i + 1] = _mm_unpackhi_epi32(a[i], a[i + 1]);
+			b[i + 2] = _mm_unpacklo_epi32(a[i + 2], a[i + 3]);
+			b[i + 3] = _mm_unpackhi_epi32(a[i + 2], a[i + 3]);
+		}
+		// b[0], b[1] hold columns 0-1, 2-3 of rows 0-3, b[2], b[3] the same of rows 4-7
+		for(std::size_t i = 0; i < 8; i += 4) {
+			r[i] = _mm_unpacklo_epi64(b[i], b[i + 2]);
+			r[i + 1] = _mm_unpackhi_epi64(b[i], b[i + 2]);
+			r[i + 2] = _mm_unpacklo_epi64(b[i + 1], b[i + 3]);
+			r[i + 3] = _mm_unpackhi_epi64(b[i + 1], b[i + 3]);
+		}
+	}
+
+	for(std::size_t i = 0; i < L; i++)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dst_stride), r[i]);
+}
+#endif
+
+/**
+ * Number of elements per side of the SIMD transpose for this layout, or 0 if there is none.
+ */
+template <typename Tp, std::size_t Channels>
+constexpr std::size_t transpose_lanes() noexcept
+{
+#if defined(__SSE2__)
+	if(std::is_trivially_copyable<Tp>::value && (sizeof(Tp) == 2 || sizeof(Tp) == 4)
+	   && Channels % (16 / sizeof(Tp)) == 0)
+		return 16 / sizeof(Tp);
+#endif
+	return 0;
+}
+
+/**
+ * Copy `frames` interleaved frames from `src` to planes `stride` elements apart in `dst`.
+ */
+template <typename Tp, std::size_t Channels>
+inline void deinterleave(const Tp* src, std::size_t frames, Tp* dst, std::size_t stride)
+{
+	std::size_t f = 0;
+#if defined(__SSE2__)
+	constexpr std::size_t L = transpose_lanes<Tp, Channels>();
+	if constexpr(L > 0) {
+		for(; f + L <= frames; f += L) {
+			const Tp* s = src + f * Channels;
+			for(std::size_t c = 0; c < Channels; c += L)
+				transpose_block(s + c, Channels, dst + c * stride + f, stride);
+		}
+	}
+#endif
+	for(; f < frames; f++)
+		for(std::size_t c = 0; c < Channels; c++)
+			dst[c * stride + f] = src[f * Channels + c];
+}
+
+/**
+ * Copy `frames` frames from planes `stride` elements apart in `src` to interleaved `dst`.
+ */
+template <typename Tp, std::size_t Channels>
+inline void interleave(const Tp* src, std::size_t stride, std::size_t frames, Tp* dst)
+{
+	std::size_t f = 0;
+#if defined(__SSE2__)
+	constexpr std::size_t L = transpose_lanes<Tp, Channels>();
+	if constexpr(L > 0) {
+		for(; f + L <= frames; f += L) {
+			Tp* d = dst + f * Channels;
+			for(std::size_t c = 0; c < Channels; c += L)
+				transpose_block(src + c * stride + f, stride, d + c, Channels);
+		}
+	}
+#endif
+	for(; f < frames; f++)
+		for(std::size_t c = 0; c < Channels; c++)
+			dst[f * Channels + c] = src[c * stride + f];
+}
+
+} // namespace detail
+
+/**
+ * First-in, first-out buffer of multi-channel frames, stored planar.
+ *
+ * Frames are pushed and popped interleaved (`ch0 ch1 ... ch0 ch1 ...`, like most acquisition
+ * hardware and audio APIs deliver them), but each channel is kept in its own ring so filters can
+ * run over the segments of one channel directly. push_list() and pop_list() (de)interleave
+ * while copying, with an SSE2 transpose for 16 and 32-bit types when `Channels` is a multiple
+ * of 8 or 4 respectively.
+ *
+ * @code
+ * cc::multichannel_fifo<std::int16_t, 32, 4096> acq;
+ * acq.push_list(dma_block, frames);
+ * filter(acq.first_segment(7), acq.first_segment_size());
+ * @endcode
+ *
+ * @tparam Tp Type of each sample
+ * @tparam Channels Number of samples per frame
+ * @tparam Nm Number of frames that fit in the fifo until full
+ */
+template <typename Tp, std::size_t Channels, std::size_t Nm>
+class multichannel_fifo {
+	static_assert(Channels > 0, "Need at least one channel");
+
+public:
+	typedef Tp value_type;
+
+	multichannel_fifo()
+		: m_tail(0)
+		, m_head(0)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Make the fifo empty (memory is not actually overwritten).
+	 */
+	void truncate()
+	{
+		m_tail = 0;
+		m_head = 0;
+	}
+
+	/**
+	 * Get the number of frames.
+	 */
+	std::size_t size() const noexcept
+	{
+		return m_head - m_tail;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_head == m_tail;
+	}
+
+	std::size_t free() const noexcept
+	{
+		return max_size() - size();
+	}
+
+	bool full() const noexcept
+	{
+		return size() == max_size();
+	}
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return Nm;
+	}
+
+	static constexpr std::size_t channels() noexcept
+	{
+		return Channels;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	/**
+	 * Add a single frame of `Channels` samples.
+	 */
+	void push(const value_type* frame)
+	{
+		if(full())
+			std::__throw_out_of_range("multichannel_fifo::push"); // No space left
+
+		const std::size_t pos = head_modulo();
+		for(std::size_t c = 0; c < Channels; c++)
+			plane(c)[pos] = frame[c];
+		m_head++;
+	}
+
+	/**
+	 * Remove a single frame of `Channels` samples.
+	 */
+	void pop(value_type* frame)
+	{
+		if(empty())
+			std::__throw_out_of_range("multichannel_fifo::pop"); // No items left
+
+		for(std::size_t c = 0; c < Channels; c++)
+			frame[c] = plane(c)[m_tail];
+		increment_tail();
+	}
+
+	/**
+	 * Add `frames` interleaved frames.
+	 */
+	void push_list(const value_type* interleaved, std::size_t frames)
+	{
+		if(free() < frames)
+			std::__throw_out_of_range("multichannel_fifo::push_list"); // No space left
+
+		const std::size_t pos = head_modulo();
+		const std::size_t n1 = std::min(frames, Nm - pos);
+		detail::deinterleave<Tp, Channels>(interleaved, n1, m_data.data() + pos, Nm);
+		detail::deinterleave<Tp, Channels>(
+			interleaved + n1 * Channels, frames - n1, m_data.data(), Nm);
+		m_head += frames;
+	}
+
+	/**
+	 * Remove frames, interleaved.
+	 *
+	 * @param frames Number of frames - Default: take all available frames
+	 */
+	void pop_list(value_type* interleaved, std::size_t frames = 0)
+	{
+		if(frames > size())
+			std::__throw_out_of_range("multichannel_fifo::pop_list"); // No items left
+		else if(frames == 0)
+			frames = size();
+
+		const std::size_t n1 = std::min(frames, Nm - m_tail);
+		detail::interleave<Tp, Channels>(m_data.data() + m_tail, Nm, n1, interleaved);
+		detail::interleave<Tp, Channels>(
+			m_data.data(), Nm, frames - n1, interleaved + n1 * Channels);
+		increment_tail(frames);
+	}
+
+	/**
+	 * Add `frames` frames from separate channel arrays, `planes[c]` for channel `c`.
+	 */
+	void push_planar(const value_type* const planes[], std::size_t frames)
+	{
+		if(free() < frames) // No space left
+			std::__throw_out_of_range("multichannel_fifo::push_planar");
+
+		const std::size_t pos = head_modulo();
+		const std::size_t n1 = std::min(frames, Nm - pos);
+		for(std::size_t c = 0; c < Channels; c++) {
+			std::copy(planes[c], planes[c] + n1, plane(c) + pos);
+			std::copy(planes[c] + n1, planes[c] + frames, plane(c));
+		}
+		m_head += frames;
+	}
+
+	/**
+	 * Remove frames to separate channel arrays, `planes[c]` for channel `c`.
+	 *
+	 * @param frames Number of frames - Default: take all available frames
+	 */
+	void pop_planar(value_type* const planes[], std::size_t frames = 0)
+	{
+		if(frames > size())
+			std::__throw_out_of_range("multichannel_fifo::pop_planar"); // No items left
+		else if(frames == 0)
+			frames = size();
+
+		const std::size_t n1 = std::min(frames, Nm - m_tail);
+		for(std::size_t c = 0; c < Channels; c++) {
+			std::copy(plane(c) + m_tail, plane(c) + m_tail + n1, planes[c]);
+			std::copy(plane(c), plane(c) + (frames - n1), planes[c] + n1);
+		}
+		increment_tail(frames);
+	}
+
+	/**
+	 * Remove the `n` oldest frames, without copying them anywhere.
+	 */
+	void discard(std::size_t n)
+	{
+		if(n > size())
+			std::__throw_out_of_range("multichannel_fifo::discard"); // No items left
+		increment_tail(n);
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Segment access
+	 *
+	 * Like `fifo`, the samples of each channel occupy at most two contiguous segments. The
+	 * segment sizes are the same for all channels.
+	 */
+	/* @{ */
+
+	const value_type* first_segment(std::size_t channel) const noexcept
+	{
+		return plane(channel) + m_tail;
+	}
+
+	std::size_t first_segment_size() const noexcept
+	{
+		return std::min(size(), Nm - m_tail);
+	}
+
+	const value_type* second_segment(std::size_t channel) const noexcept
+	{
+		return plane(channel);
+	}
+
+	std::size_t second_segment_size() const noexcept
+	{
+		return size() - first_segment_size();
+	}
+
+	/* @} */
+
+protected:
+	value_type* plane(std::size_t channel) noexcept
+	{
+		return m_data.data() + channel * Nm;
+	}
+
+	const value_type* plane(std::size_t channel) const noexcept
+	{
+		return m_data.data() + channel * Nm;
+	}
+
+	void increment_tail(std::size_t incr = 1)
+	{
+		m_tail += incr;
+		if(m_tail >= Nm) {
+			m_tail -= Nm;
+			m_head -= Nm;
+		}
+	}
+
+	std::size_t head_modulo() const
+	{
+		return m_head % Nm;
+	}
+
+	std::array<Tp, Channels * Nm> m_data; // Channel `c` occupies [c * Nm, (c + 1) * Nm)
+	std::size_t m_tail; // Frame index of the next frame to read, modulo Nm
+	std::size_t m_head; // Frame index of the next frame to write, up to 2 * Nm
+};
+
+} // namespace cc
+
+#endif /* MULTICHANNEL_FIFO_H */
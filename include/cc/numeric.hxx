@@ -0,0 +1,794 @@
+#ifndef NUMERIC_H
+#define NUMERIC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(__AVX__)
+#	include <immintrin.h>
+#endif
+
+#include "buffer.hxx"
+#include "fifo.hxx"
+
+namespace cc {
+
+/**
+ * Summation method for the reductions and scans below.
+ */
+enum class summation {
+	/**
+	 * Independent SIMD lanes, combined at the end. Fastest; the error grows with n / lanes.
+	 */
+	lanes,
+	/**
+	 * SIMD lanes over blocks, combined pairwise. Nearly as fast; the error grows with log(n).
+	 */
+	pairwise,
+	/**
+	 * Kahan-compensated SIMD lanes. About half as fast; the error does not grow with n.
+	 */
+	kahan,
+};
+
+namespace detail {
+
+/**
+ * Vector operations for the reduction kernels, one lane (plain scalar code) by default.
+ */
+template <typename Tp>
+struct simd_ops {
+	typedef Tp vec;
+	static constexpr std::size_t width = 1;
+
+	static vec load(const Tp* p) noexcept
+	{
+		return *p;
+	}
+
+	static vec set1(Tp v) noexcept
+	{
+		return v;
+	}
+
+	static vec add(vec a, vec b) noexcept
+	{
+		return a + b;
+	}
+
+	static vec sub(vec a, vec b) noexcept
+	{
+		return a - b;
+	}
+
+	static vec mul(vec a, vec b) noexcept
+	{
+		return a * b;
+	}
+
+	static vec min(vec a, vec b) noexcept
+	{
+		return b < a ? b : a;
+	}
+
+	static vec max(vec a, vec b) noexcept
+	{
+		return a < b ? b : a;
+	}
+
+	static void store(Tp* p, vec v) noexcept
+	{
+		*p = v;
+	}
+};
+
+#if defined(__AVX__)
+template <>
+struct simd_ops<float> {
+	typedef __m256 vec;
+	static constexpr std::size_t width = 8;
+
+	static vec load(const float* p) noexcept
+	{
+		return _mm256_loadu_ps(p);
+	}
+
+	static vec set1(float v) noexcept
+	{
+		return _mm256_set1_ps(v);
+	}
+
+	static vec add(vec a, vec b) noexcept
+	{
+		return _mm256_add_ps(a, b);
+	}
+
+	static vec sub(vec a, vec b) noexcept
+	{
+		return _mm256_sub_ps(a, b);
+	}
+
+	static vec mul(vec a, vec b) noexcept
+	{
+		return _mm256_mul_ps(a, b);
+	}
+
+	static vec min(vec a, vec b) noexcept
+	{
+		return _mm256_min_ps(b, a);
+	}
+
+	static vec max(vec a, vec b) noexcept
+	{
+		return _mm256_max_ps(b, a);
+	}
+
+	static void store(float* p, vec v) noexcept
+	{
+		_mm256_storeu_ps(p, v);
+	}
+};
+
+template <>
+struct simd_ops<double> {
+	typedef __m256d vec;
+	static constexpr std::size_t width = 4;
+
+	static vec load(const double* p) noexcept
+	{
+		return _mm256_loadu_pd(p);
+	}
+
+	static vec set1(double v) noexcept
+	{
+		return _mm256_set1_pd(v);
+	}
+
+	static vec add(vec a, vec b) noexcept
+	{
+		return _mm256_add_pd(a, b);
+	}
+
+	static vec sub(vec a, vec b) noexcept
+	{
+		return _mm256_sub_pd(a, b);
+	}
+
+	static vec mul(vec a, vec b) noexcept
+	{
+		return _mm256_mul_pd(a, b);
+	}
+
+	static vec min(vec a, vec b) noexcept
+	{
+		return _mm256_min_pd(b, a);
+	}
+
+	static vec max(vec a, vec b) noexcept
+	{
+		return _mm256_max_pd(b, a);
+	}
+
+	static void store(double* p, vec v) noexcept
+	{
+		_mm256_storeu_pd(p, v);
+	}
+};
+#elif defined(__SSE2__)
+template <>
+struct simd_ops<float> {
+	typedef __m128 vec;
+	static constexpr std::size_t width = 4;
+
+	static vec load(const float* p) noexcept
+	{
+		return _mm_loadu_ps(p);
+	}
+
+	static vec set1(float v) noexcept
+	{
+		return _mm_set1_ps(v);
+	}
+
+	static vec add(vec a, vec b) noexcept
+	{
+		return _mm_add_ps(a, b);
+	}
+
+	static vec sub(vec a, vec b) noexcept
+	{
+		return _mm_sub_ps(a, b);
+	}
+
+	static vec mul(vec a, vec b) noexcept
+	{
+		return _mm_mul_ps(a, b);
+	}
+
+	static vec min(vec a, vec b) noexcept
+	{
+		return _mm_min_ps(b, a);
+	}
+
+	static vec max(vec a, vec b) noexcept
+	{
+		return _mm_max_ps(b, a);
+	}
+
+	static void store(float* p, vec v) noexcept
+	{
+		_mm_storeu_ps(p, v);
+	}
+};
+
+template <>
+struct simd_ops<double> {
+	typedef __m128d vec;
+	static constexpr std::size_t width = 2;
+
+	static vec load(const double* p) noexcept
+	{
+		return _mm_loadu_pd(p);
+	}
+
+	static vec set1(double v) noexcept
+	{
+		return _mm_set1_pd(v);
+	}
+
+	static vec add(vec a, vec b) noexcept
+	{
+		return _mm_add_pd(a, b);
+	}
+
+	static vec sub(vec a, vec b) noexcept
+	{
+		return _mm_sub_pd(a, b);
+	}
+
+	static vec mul(vec a, vec b) noexcept
+	{
+		return _mm_mul_pd(a, b);
+	}
+
+	static vec min(vec a, vec b) noexcept
+	{
+		return _mm_min_pd(b, a);
+	}
+
+	static vec max(vec a, vec b) noexcept
+	{
+		return _mm_max_pd(b, a);
+	}
+
+	static void store(double* p, vec v) noexcept
+	{
+		_mm_storeu_pd(p, v);
+	}
+};
+#endif
+
+/**
+ * Running sum with its Kahan compensation, such that reductions can continue over segments.
+ */
+template <typename Tp>
+struct sum_state {
+	Tp sum = Tp();
+	Tp error = Tp(); // Negated low-order bits lost from `sum` (Kahan mode only)
+
+	void add(Tp x) noexcept
+	{
+		const Tp y = x - error;
+		const Tp t = sum + y;
+		error = (t - sum) - y;
+		sum = t;
+	}
+};
+
+/**
+ * Add the lanes of a vector in a fixed tree order.
+ */
+template <typename Tp>
+inline Tp horizontal_sum(typename simd_ops<Tp>::vec v) noexcept
+{
+	typedef simd_ops<Tp> ops;
+	Tp lanes[ops::width];
+	ops::store(lanes, v);
+	for(std::size_t w = ops::width / 2; w > 0; w /= 2)
+		for(std::size_t i = 0; i < w; i++)
+			lanes[i] += lanes[i + w];
+	return lanes[0];
+}
+
+/**
+ * Sum `term(i)` for i in [first, last) with four independent vector accumulators.
+ *
+ * `term(i)` returns the vector for elements i to i + width, `scalar(i)` a single element.
+ */
+template <typename Tp, typename Term, typename Scalar>
+inline Tp sum_lanes(std::size_t first, std::size_t last, Term&& term, Scalar&& scalar)
+{
+	typedef simd_ops<Tp> ops;
+	constexpr std::size_t W = ops::width;
+
+	typename ops::vec a0 = ops::set1(Tp()), a1 = a0, a2 = a0, a3 = a0;
+	std::size_t i = first;
+	for(; i + 4 * W <= last; i += 4 * W) {
+		a0 = ops::add(a0, term(i));
+		a1 = ops::add(a1, term(i + W));
+		a2 = ops::add(a2, term(i + 2 * W));
+		a3 = ops::add(a3, term(i + 3 * W));
+	}
+	for(; i + W <= last; i += W)
+		a0 = ops::add(a0, term(i));
+
+	Tp s = horizontal_sum<Tp>(ops::add(ops::add(a0, a1), ops::add(a2, a3)));
+	for(; i < last; i++)
+		s += scalar(i);
+	return s;
+}
+
+/**
+ * Kahan-compensated sum of `term(i)` for i in [first, last), continuing from `state`.
+ */
+template <typename Tp, typename Term, typename Scalar>
+inline void sum_kahan(
+	sum_state<Tp>& state, std::size_t first, std::size_t last, Term&& term, Scalar&& scalar)
+{
+	typedef simd_ops<Tp> ops;
+	constexpr std::size_t W = ops::width;
+
+	typename ops::vec s0 = ops::set1(Tp()), s1 = s0, c0 = s0, c1 = s0;
+	auto step = [](typename ops::vec& s, typename ops::vec& c, typename ops::vec x) {
+		const auto y = ops::sub(x, c);
+		const auto t = ops::add(s, y);
+		c = ops::sub(ops::sub(t, s), y);
+		s = t;
+	};
+
+	std::size_t i = first;
+	for(; i + 2 * W <= last; i += 2 * W) {
+		step(s0, c0, term(i));
+		step(s1, c1, term(i + W));
+	}
+	for(; i + W <= last; i += W)
+		step(s0, c0, term(i));
+
+	Tp s[2][W], c[2][W];
+	ops::store(s[0], s0);
+	ops::store(s[1], s1);
+	ops::store(c[0], c0);
+	ops::store(c[1], c1);
+	for(std::size_t k = 0; k < 2; k++)
+		for(std::size_t j = 0; j < W; j++) {
+			state.add(s[k][j]);
+			state.add(-c[k][j]);
+		}
+	for(; i < last; i++)
+		state.add(scalar(i));
+}
+
+/**
+ * Pairwise sum of `term(i)` for i in [first, last), over blocks of lane sums.
+ */
+template <typename Tp, typename Term, typename Scalar>
+inline Tp sum_pairwise(std::size_t first, std::size_t last, Term&& term, Scalar&& scalar)
+{
+	constexpr std::size_t block = 256;
+	if(last - first <= block)
+		return sum_lanes<Tp>(first, last, term, scalar);
+
+	// Split on a whole number of blocks, such that all but the last are full
+	const std::size_t half = (last - first + block) / (2 * block) * block;
+	return sum_pairwise<Tp>(first, first + half, term, scalar)
+	       + sum_pairwise<Tp>(first + half, last, term, scalar);
+}
+
+template <summation S, typename Tp, typename Term, typename Scalar>
+inline void accumulate(
+	sum_state<Tp>& state, std::size_t first, std::size_t last, Term&& term, Scalar&& scalar)
+{
+	if constexpr(S == summation::kahan)
+		sum_kahan<Tp>(state, first, last, term, scalar);
+	else if constexpr(S == summation::pairwise)
+		state.sum += sum_pairwise<Tp>(first, last, term, scalar);
+	else
+		state.sum += sum_lanes<Tp>(first, last, term, scalar);
+}
+
+/**
+ * Add the sum of `p[0..n)` to `state`.
+ */
+template <summation S, typename Tp>
+inline void accumulate_range(sum_state<Tp>& state, const Tp* p, std::size_t n)
+{
+	typedef simd_ops<Tp> ops;
+	accumulate<S>(
+		state, 0, n, [p](std::size_t i) { return ops::load(p + i); },
+		[p](std::size_t i) { return p[i]; });
+}
+
+/**
+ * Add the sum of `a[i] * b[i]` over `n` elements to `state`.
+ */
+template <summation S, typename Tp>
+inline void accumulate_dot(sum_state<Tp>& state, const Tp* a, const Tp* b, std::size_t n)
+{
+	typedef simd_ops<Tp> ops;
+	accumulate<S>(
+		state, 0, n,
+		[a, b](std::size_t i) { return ops::mul(ops::load(a + i), ops::load(b + i)); },
+		[a, b](std::size_t i) { return a[i] * b[i]; });
+}
+
+/**
+ * Add the sum of `(p[i] - mean)^2` over `n` elements to `state`.
+ */
+template <summation S, typename Tp>
+inline void accumulate_squares(sum_state<Tp>& state, const Tp* p, std::size_t n, Tp mean)
+{
+	typedef simd_ops<Tp> ops;
+	const typename ops::vec m = ops::set1(mean);
+	accumulate<S>(
+		state, 0, n,
+		[p, m](std::size_t i) {
+			const auto d = ops::sub(ops::load(p + i), m);
+			return ops::mul(d, d);
+		},
+		[p, mean](std::size_t i) { return (p[i] - mean) * (p[i] - mean); });
+}
+
+/**
+ * Integer type wide enough to sum many elements of the integer type `Tp` without wrapping.
+ */
+template <typename Tp>
+using wide_int =
+	typename std::conditional<std::is_signed<Tp>::value, std::int64_t, std::uint64_t>::type;
+
+/**
+ * Get the sum of the integer elements of a buffer or fifo, in 64 bits.
+ */
+template <typename Container>
+inline wide_int<typename Container::value_type> wide_sum(const Container& c) noexcept
+{
+	wide_int<typename Container::value_type> sum = 0;
+	for(const auto& v : c)
+		sum += v;
+	return sum;
+}
+
+/**
+ * Get the population variance of the integer elements of a non-empty buffer or fifo, in double
+ * precision around the exact mean.
+ */
+template <typename Container>
+inline double wide_variance(const Container& c) noexcept
+{
+	const double n = static_cast<double>(c.size());
+	const double mean = static_cast<double>(wide_sum(c)) / n;
+	double sum = 0;
+	for(const auto& v : c) {
+		const double d = static_cast<double>(v) - mean;
+		sum += d * d;
+	}
+	return sum / n;
+}
+
+/**
+ * Update `lo` and `hi` with the extremes of `p[0..n)`.
+ */
+template <typename Tp>
+inline void minmax_range(const Tp* p, std::size_t n, Tp& lo, Tp& hi)
+{
+	typedef simd_ops<Tp> ops;
+	constexpr std::size_t W = ops::width;
+
+	std::size_t i = 0;
+	if(n >= 2 * W) {
+		typename ops::vec l0 = ops::set1(lo), l1 = l0, h0 = ops::set1(hi), h1 = h0;
+		for(; i + 2 * W <= n; i += 2 * W) {
+			const auto x0 = ops::load(p + i);
+			const auto x1 = ops::load(p + i + W);
+			l0 = ops::min(l0, x0);
+			l1 = ops::min(l1, x1);
+			h0 = ops::max(h0, x0);
+			h1 = ops::max(h1, x1);
+		}
+		Tp l[W], h[W];
+		ops::store(l, ops::min(l0, l1));
+		ops::store(h, ops::max(h0, h1));
+		for(std::size_t j = 0; j < W; j++) {
+			lo = std::min(lo, l[j]);
+			hi = std::max(hi, h[j]);
+		}
+	}
+	for(; i < n; i++) {
+		lo = std::min(lo, p[i]);
+		hi = std::max(hi, p[i]);
+	}
+}
+
+/**
+ * Write the inclusive prefix sums of `in[0..n)` plus the running sum in `state` to `out`,
+ * which may equal `in`, and add the elements to `state`. The Kahan compensation is kept in
+ * `state` too, so a scan can continue over segments.
+ *
+ * With `Inclusive == false`, write the exclusive ones instead.
+ */
+template <summation S, bool Inclusive, typename Tp>
+inline void scan(const Tp* in, Tp* out, std::size_t n, sum_state<Tp>& state)
+{
+	std::size_t i = 0;
+
+	if constexpr(S == summation::kahan) {
+		for(; i < n; i++) {
+			const Tp v = in[i];
+			if(!Inclusive)
+				out[i] = state.sum;
+			state.add(v);
+			if(Inclusive)
+				out[i] = state.sum;
+		}
+		return;
+	}
+
+	Tp carry = state.sum;
+
+#if defined(__SSE2__)
+	// Prefix sums within a vector take log2(lanes) shift-and-add steps
+	if constexpr(std::is_same<Tp, float>::value) {
+		__m128 c = _mm_set1_ps(carry);
+		for(; i + 4 <= n; i += 4) {
+			__m128 x = _mm_loadu_ps(in + i);
+			x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+			x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+			const __m128 shifted =
+				_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4));
+			_mm_storeu_ps(out + i, _mm_add_ps(Inclusive ? x : shifted, c));
+			c = _mm_add_ps(c, _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+		carry = _mm_cvtss_f32(c);
+	} else if constexpr(std::is_same<Tp, double>::value) {
+		__m128d c = _mm_set1_pd(carry);
+		for(; i + 2 <= n; i += 2) {
+			__m128d x = _mm_loadu_pd(in + i);
+			x = _mm_add_pd(x, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(x), 8)));
+			const __m128d shifted =
+				_mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(x), 8));
+			_mm_storeu_pd(out + i, _mm_add_pd(Inclusive ? x : shifted, c));
+			c = _mm_add_pd(c, _mm_unpackhi_pd(x, x));
+		}
+		carry = _mm_cvtsd_f64(c);
+	} else if constexpr(std::is_integral<Tp>::value && sizeof(Tp) == 4) {
+		__m128i c = _mm_set1_epi32(static_cast<int>(carry));
+		for(; i + 4 <= n; i += 4) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+			const __m128i v = Inclusive ? x : _mm_slli_si128(x, 4);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi32(v, c));
+			c = _mm_add_epi32(c, _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+		carry = static_cast<Tp>(_mm_cvtsi128_si32(c));
+	}
+#endif
+
+	for(; i < n; i++) {
+		const Tp v = in[i];
+		if(!Inclusive)
+			out[i] = carry;
+		carry += v;
+		if(Inclusive)
+			out[i] = carry;
+	}
+	state.sum = carry;
+}
+
+} // namespace detail
+
+/**
+ * @defgroup Reductions
+ *
+ * Sums and statistics over the used elements of a buffer, or over both segments of a fifo.
+ *
+ * These are vectorized by hand, so they don't need `-ffast-math`: the order of the additions
+ * is fixed by the chosen summation method, and results are the same for every build with the
+ * same instruction set. Use `summation::kahan` when the result has to be nearly independent of
+ * the number of elements.
+ */
+/* @{ */
+
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+Tp sum(const buffer<Tp, Nm, Trace>& b)
+{
+	detail::sum_state<Tp> state;
+	detail::accumulate_range<S>(state, b.data(), b.size());
+	return state.sum;
+}
+
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+Tp sum(const fifo<Tp, Nm, Trace>& f)
+{
+	detail::sum_state<Tp> state;
+	detail::accumulate_range<S>(state, f.first_segment(), f.first_segment_size());
+	detail::accumulate_range<S>(state, f.second_segment(), f.second_segment_size());
+	return state.sum;
+}
+
+/**
+ * Get the average of the elements, which must not be empty.
+ *
+ * Integers are summed in 64 bits, so that narrow types don't wrap, and the average is rounded
+ * toward zero.
+ */
+template <summation S = summation::pairwise, typename Container>
+auto mean(const Container& c)
+{
+	typedef typename Container::value_type value_type;
+	if(c.empty())
+		std::__throw_out_of_range("cc::mean");
+	if constexpr(std::is_integral<value_type>::value) {
+		const auto total = detail::wide_sum(c);
+		return static_cast<value_type>(total / static_cast<decltype(total)>(c.size()));
+	} else {
+		return sum<S>(c) / static_cast<value_type>(c.size());
+	}
+}
+
+/**
+ * Get the population variance (divided by n) of the elements, which must not be empty.
+ *
+ * Uses two passes, the second over the squared deviations from the mean, which avoids the
+ * cancellation of the single-pass formula. Integers are computed in double precision, and the
+ * result rounded toward zero.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+Tp variance(const buffer<Tp, Nm, Trace>& b)
+{
+	if constexpr(std::is_integral<Tp>::value) {
+		if(b.empty())
+			std::__throw_out_of_range("cc::variance");
+		return static_cast<Tp>(detail::wide_variance(b));
+	} else {
+		const Tp m = mean<S>(b);
+		detail::sum_state<Tp> state;
+		detail::accumulate_squares<S>(state, b.data(), b.size(), m);
+		return state.sum / static_cast<Tp>(b.size());
+	}
+}
+
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+Tp variance(const fifo<Tp, Nm, Trace>& f)
+{
+	if constexpr(std::is_integral<Tp>::value) {
+		if(f.empty())
+			std::__throw_out_of_range("cc::variance");
+		return static_cast<Tp>(detail::wide_variance(f));
+	} else {
+		const Tp m = mean<S>(f);
+		detail::sum_state<Tp> state;
+		const std::size_t n1 = f.first_segment_size(), n2 = f.second_segment_size();
+		detail::accumulate_squares<S>(state, f.first_segment(), n1, m);
+		detail::accumulate_squares<S>(state, f.second_segment(), n2, m);
+		return state.sum / static_cast<Tp>(f.size());
+	}
+}
+
+/**
+ * Get the dot product of two buffers of the same size.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace,
+	  std::size_t N2, typename Trace2>
+Tp dot(const buffer<Tp, Nm, Trace>& a, const buffer<Tp, N2, Trace2>& b)
+{
+	if(a.size() != b.size())
+		std::__throw_out_of_range("cc::dot");
+	detail::sum_state<Tp> state;
+	detail::accumulate_dot<S>(state, a.data(), b.data(), a.size());
+	return state.sum;
+}
+
+/**
+ * Get the dot product of the fifo, from oldest to newest, with the first size() elements of
+ * `other`, like a FIR filter over the history.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+Tp dot(const fifo<Tp, Nm, Trace>& f, const Tp* other)
+{
+	const std::size_t n1 = f.first_segment_size();
+	detail::sum_state<Tp> state;
+	detail::accumulate_dot<S>(state, f.first_segment(), other, n1);
+	detail::accumulate_dot<S>(state, f.second_segment(), other + n1, f.second_segment_size());
+	return state.sum;
+}
+
+/**
+ * Get the smallest and the largest element, which must not be empty.
+ *
+ * The result is unspecified if there are NaNs.
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+std::pair<Tp, Tp> minmax(const buffer<Tp, Nm, Trace>& b)
+{
+	if(b.empty())
+		std::__throw_out_of_range("cc::minmax");
+	std::pair<Tp, Tp> r(b[0], b[0]);
+	detail::minmax_range(b.data(), b.size(), r.first, r.second);
+	return r;
+}
+
+template <typename Tp, std::size_t Nm, typename Trace>
+std::pair<Tp, Tp> minmax(const fifo<Tp, Nm, Trace>& f)
+{
+	if(f.empty())
+		std::__throw_out_of_range("cc::minmax");
+	std::pair<Tp, Tp> r(f.front(), f.front());
+	detail::minmax_range(f.first_segment(), f.first_segment_size(), r.first, r.second);
+	detail::minmax_range(f.second_segment(), f.second_segment_size(), r.first, r.second);
+	return r;
+}
+
+/* @} */
+
+/**
+ * @defgroup Scans
+ *
+ * Prefix sums. The lanes and pairwise methods add within SSE2 vectors first (float, double and
+ * 32-bit integers), so float results can differ in the last bits from a sequential loop;
+ * `summation::kahan` runs a compensated sequential scan.
+ */
+/* @{ */
+
+/**
+ * Replace every element by the sum of itself and all elements before it.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+void inclusive_scan(buffer<Tp, Nm, Trace>& b)
+{
+	detail::sum_state<Tp> state;
+	detail::scan<S, true>(b.data(), b.data(), b.size(), state);
+}
+
+/**
+ * Replace every element by `init` plus the sum of all elements before it.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+void exclusive_scan(buffer<Tp, Nm, Trace>& b, Tp init = Tp())
+{
+	detail::sum_state<Tp> state;
+	state.sum = init;
+	detail::scan<S, false>(b.data(), b.data(), b.size(), state);
+}
+
+/**
+ * Write the inclusive prefix sums of the fifo, from oldest to newest, to `out`.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+void inclusive_scan(const fifo<Tp, Nm, Trace>& f, Tp* out)
+{
+	const std::size_t n1 = f.first_segment_size();
+	detail::sum_state<Tp> state;
+	detail::scan<S, true>(f.first_segment(), out, n1, state);
+	detail::scan<S, true>(f.second_segment(), out + n1, f.second_segment_size(), state);
+}
+
+/**
+ * Write `init` plus the exclusive prefix sums of the fifo, from oldest to newest, to `out`.
+ */
+template <summation S = summation::pairwise, typename Tp, std::size_t Nm, typename Trace>
+void exclusive_scan(const fifo<Tp, Nm, Trace>& f, Tp* out, Tp init = Tp())
+{
+	const std::size_t n1 = f.first_segment_size();
+	detail::sum_state<Tp> state;
+	state.sum = init;
+	detail::scan<S, false>(f.first_segment(), out, n1, state);
+	detail::scan<S, false>(f.second_segment(), out + n1, f.second_segment_size(), state);
+}
+
+/* @} */
+
+} // namespace cc
+
+#endif /* NUMERIC_H */
@@ -0,0 +1,230 @@
+#ifndef PACKED_BUFFER_H
+#define PACKED_BUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+#include "bitstream.hxx"
+#include "buffer.hxx"
+
+namespace cc {
+
+/**
+ * Buffer of unsigned integers of `Bits` bits each, packed into 64-bit words.
+ *
+ * Behaves like `cc::buffer` with respect to size, but elements are not addressable, so use
+ * get() and set() instead of references. Values are truncated to `Bits` bits when stored.
+ *
+ * @tparam Bits Number of bits per element, 1 to 63
+ * @tparam Nm Max size of this buffer
+ */
+template <unsigned Bits, std::size_t Nm>
+class packed_buffer {
+	static_assert(Bits >= 1 && Bits <= 63, "Invalid bit width");
+
+public:
+	typedef std::uint64_t value_type;
+
+	packed_buffer()
+		: m_words()
+		, m_used(0)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Reset size() to zero or force it to a specific value.
+	 */
+	void reset(std::size_t n = 0)
+	{
+		m_used = n;
+	}
+
+	std::size_t size() const noexcept
+	{
+		return m_used;
+	}
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return Nm;
+	}
+
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	std::size_t free() const noexcept
+	{
+		return max_size() - m_used;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	value_type get(std::size_t n) const
+	{
+		if(n >= m_used)
+			std::__throw_out_of_range("packed_buffer::get");
+		return operator[](n);
+	}
+
+	void set(std::size_t n, value_type v)
+	{
+		if(n >= m_used)
+			std::__throw_out_of_range("packed_buffer::set");
+		store(n, v);
+	}
+
+	/**
+	 * Get an element, without checking the size (like `buffer[n]`).
+	 */
+	value_type operator[](std::size_t n) const noexcept
+	{
+		const std::size_t pos = n * Bits;
+		const std::size_t i = pos / 64;
+		const unsigned off = static_cast<unsigned>(pos % 64);
+
+		// Two shifts, to shift by 64 without undefined behavior when off == 0
+		const std::uint64_t v = m_words[i] >> off | (m_words[i + 1] << 1) << (63 - off);
+		return detail::low_bits(v, Bits);
+	}
+
+	/**
+	 * Set an element, and extend size() if needed (like `buffer::assign()`).
+	 */
+	void assign(std::size_t n, value_type v)
+	{
+		if(n >= max_size())
+			std::__throw_out_of_range("packed_buffer::assign");
+		store(n, v);
+		m_used = std::max(m_used, n + 1);
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	void push_back(value_type v)
+	{
+		if(m_used == max_size())
+			std::__throw_out_of_range("packed_buffer::push_back");
+		store(m_used, v);
+		m_used++;
+	}
+
+	value_type pop_back()
+	{
+		if(m_used == 0)
+			std::__throw_out_of_range("packed_buffer::pop");
+		m_used--;
+		return operator[](m_used);
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Bulk access
+	 */
+	/* @{ */
+
+	/**
+	 * Append all elements to a normal buffer.
+	 *
+	 * With AVX2, eight elements of up to 25 bits are unpacked at a time into 32-bit integers,
+	 * or up to 16 bits into 16-bit integers.
+	 */
+	template <typename Tp, std::size_t N, typename Trace>
+	void unpack(buffer<Tp, N, Trace>& out) const
+	{
+		static_assert(std::is_integral<Tp>::value, "Can only unpack to integers");
+
+		if(out.free() < m_used)
+			std::__throw_out_of_range("packed_buffer::unpack"); // Not enough space
+
+		Tp* dst = out.data() + out.size();
+		std::size_t i = 0;
+
+#if defined(__AVX2__)
+		constexpr bool gather =
+			Bits <= 25 && (sizeof(Tp) == 4 || (sizeof(Tp) == 2 && Bits <= 16));
+		if constexpr(gather) {
+			// Eight elements span exactly Bits bytes, so the byte offset and shift
+			// of each lane within a group are the same for all groups.
+			const __m256i k = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			const __m256i bit = _mm256_mullo_epi32(k, _mm256_set1_epi32(Bits));
+			const __m256i offset = _mm256_srli_epi32(bit, 3);
+			const __m256i shift = _mm256_and_si256(bit, _mm256_set1_epi32(7));
+			const __m256i mask = _mm256_set1_epi32(static_cast<int>((1u << Bits) - 1u));
+			const char* bytes = reinterpret_cast<const char*>(m_words.data());
+
+			for(; i + 8 <= m_used; i += 8) {
+				// Reads at most 3 bytes past the last element (the spare word)
+				const int* base = reinterpret_cast<const int*>(bytes);
+				const __m256i raw = _mm256_i32gather_epi32(base, offset, 1);
+				const __m256i v =
+					_mm256_and_si256(_mm256_srlv_epi32(raw, shift), mask);
+				bytes += Bits;
+
+				if constexpr(sizeof(Tp) == 4) {
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+				} else {
+					const __m128i lo = _mm256_castsi256_si128(v);
+					const __m128i hi = _mm256_extracti128_si256(v, 1);
+					_mm_storeu_si128(
+						reinterpret_cast<__m128i*>(dst + i),
+						_mm_packus_epi32(lo, hi));
+				}
+			}
+		}
+#endif
+
+		for(; i < m_used; i++)
+			dst[i] = static_cast<Tp>(operator[](i));
+
+		out.reset(out.size() + m_used);
+	}
+
+	/* @} */
+
+protected:
+	void store(std::size_t n, value_type v) noexcept
+	{
+		v = detail::low_bits(v, Bits);
+		const std::size_t pos = n * Bits;
+		const std::size_t i = pos / 64;
+		const unsigned off = static_cast<unsigned>(pos % 64);
+		const std::uint64_t mask = detail::low_bits(~std::uint64_t(0), Bits);
+
+		m_words[i] = (m_words[i] & ~(mask << off)) | v << off;
+		if(off + Bits > 64) {
+			const unsigned spill = 64 - off;
+			m_words[i + 1] = (m_words[i + 1] & ~(mask >> spill)) | v >> spill;
+		}
+	}
+
+	// One spare word, such that reads never have to check the end
+	std::array<std::uint64_t, (Bits * Nm + 63) / 64 + 1> m_words;
+	std::size_t m_used; // Number of elements that are considered 'used'
+};
+
+} // namespace cc
+
+#endif /* PACKED_BUFFER_H */
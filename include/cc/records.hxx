@@ -0,0 +1,192 @@
+#ifndef RECORDS_H
+#define RECORDS_H
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+#include "fifo.hxx"
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Find the first occurrence of `c` in [first, last), like std::memchr.
+ *
+ * @return Pointer to the match, or `last` if there is none
+ */
+inline const char* find_byte(const char* first, const char* last, char c) noexcept
+{
+#if defined(__AVX2__)
+	const __m256i needle32 = _mm256_set1_epi8(c);
+	for(; last - first >= 32; first += 32) {
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+		const unsigned mask =
+			static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle32)));
+		if(mask)
+			return first + __builtin_ctz(mask);
+	}
+#endif
+#if defined(__SSE2__)
+	const __m128i needle16 = _mm_set1_epi8(c);
+	for(; last - first >= 16; first += 16) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		const unsigned mask =
+			static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle16)));
+		if(mask)
+			return first + __builtin_ctz(mask);
+	}
+#endif
+	// Remaining tail (or the whole range without SIMD)
+	const void* p = std::memchr(first, c, static_cast<std::size_t>(last - first));
+	return p ? static_cast<const char*>(p) : last;
+}
+
+} // namespace detail
+
+/**
+ * Splits the contents of a character fifo into delimited records, without copying.
+ *
+ * Records are returned as a pair of views into the fifo. A record that wraps around the end of
+ * the underlying array is split over both views, otherwise the second view is empty. The
+ * delimiter itself is not part of the record.
+ *
+ * Returned records stay in the fifo until release() is called, after which the views must no
+ * longer be used. Do not pop from the fifo directly while records are pending; pushing is fine.
+ *
+ * @code
+ * cc::record_splitter<1024> lines(input);
+ * cc::record_splitter<1024>::record_type line;
+ * while(lines.next(line))
+ *         parse(line.first, line.second);
+ * lines.release();
+ * @endcode
+ *
+ * @tparam Nm Size of the fifo
+ * @tparam Trace Trace policy of the fifo
+ */
+template <std::size_t Nm, typename Trace = CC_TRACE_POLICY>
+class record_splitter {
+public:
+	typedef std::pair<std::string_view, std::string_view> record_type;
+
+	explicit record_splitter(fifo<char, Nm, Trace>& source, char delimiter = '\n')
+		: m_source(source)
+		, m_delimiter(delimiter)
+		, m_start(0)
+		, m_scanned(0)
+	{}
+
+	/**
+	 * Find the next complete record.
+	 *
+	 * @return False if no complete record is available (yet)
+	 */
+	bool next(record_type& record)
+	{
+		const std::size_t n = m_source.size();
+		const std::size_t n1 = m_source.first_segment_size();
+		const char* s1 = m_source.first_segment();
+		const char* s2 = m_source.second_segment();
+
+		// Don't scan bytes of an incomplete record twice
+		std::size_t pos = std::max(m_start, m_scanned);
+		std::size_t found = n;
+
+		if(pos < n1) {
+			const char* p = detail::find_byte(s1 + pos, s1 + n1, m_delimiter);
+			if(p != s1 + n1)
+				found = static_cast<std::size_t>(p - s1);
+			else
+				pos = n1;
+		}
+
+		if(found == n && pos >= n1 && pos < n) {
+			const std::size_t off = pos - n1; // Start within the second segment
+			const std::size_t n2 = n - n1;
+			const char* p = detail::find_byte(s2 + off, s2 + n2, m_delimiter);
+			if(p != s2 + n2)
+				found = n1 + static_cast<std::size_t>(p - s2);
+		}
+
+		if(found == n) {
+			m_scanned = n;
+			return false;
+		}
+
+		record = view(m_start, found, n1);
+		m_start = found + 1; // Skip delimiter
+		m_scanned = m_start;
+		return true;
+	}
+
+	/**
+	 * Call `f(const record_type&)` for every complete record, then release them all.
+	 *
+	 * @return Number of records
+	 */
+	template <typename F>
+	std::size_t for_each(F&& f)
+	{
+		std::size_t count = 0;
+		record_type record;
+		while(next(record)) {
+			f(static_cast<const record_type&>(record));
+			count++;
+		}
+		release();
+		return count;
+	}
+
+	/**
+	 * Remove all records returned by next() from the fifo, including their delimiters.
+	 */
+	void release()
+	{
+		m_source.discard(m_start);
+		m_scanned -= m_start;
+		m_start = 0;
+	}
+
+	/**
+	 * Get the number of bytes that will be freed by release().
+	 */
+	std::size_t pending() const noexcept
+	{
+		return m_start;
+	}
+
+protected:
+	record_type view(std::size_t begin, std::size_t end, std::size_t n1) const
+	{
+		const char* s1 = m_source.first_segment();
+		const char* s2 = m_source.second_segment();
+
+		if(end <= n1)
+			return record_type(
+				std::string_view(s1 + begin, end - begin), std::string_view());
+		else if(begin >= n1)
+			return record_type(
+				std::string_view(s2 + (begin - n1), end - begin),
+				std::string_view());
+		else
+			return record_type(
+				std::string_view(s1 + begin, n1 - begin),
+				std::string_view(s2, end - n1));
+	}
+
+	fifo<char, Nm, Trace>& m_source;
+	char m_delimiter;
+	std::size_t m_start;   // Offset from the tail of the next record
+	std::size_t m_scanned; // Offset from the tail up to which no delimiter was found
+};
+
+} // namespace cc
+
+#endif /* RECORDS_H */
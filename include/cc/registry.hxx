@@ -0,0 +1,381 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "buffer.hxx"
+#include "fifo.hxx"
+
+namespace cc {
+
+namespace detail {
+
+template <typename Monitored>
+struct monitor_trace;
+
+} // namespace detail
+
+/**
+ * Occupancy of one registered container at the time of a snapshot.
+ */
+struct container_stats {
+	std::string name;
+	const char* kind; // "buffer" or "fifo"
+	std::size_t capacity;
+	std::size_t size;
+	std::size_t high_water; // Largest size reached
+	std::uint64_t pushes;	// Elements pushed in total
+	std::uint64_t pops;	// Elements popped in total
+	std::uint64_t full;	// Pushes that left the container full
+	double push_rate;	// Elements per second since the previous snapshot
+	double pop_rate;
+};
+
+/**
+ * Counters of one monitored container, shared with the registry.
+ *
+ * Only the thread that owns the container writes them, with plain relaxed loads and stores
+ * (no read-modify-write), so keeping them costs a few instructions per operation. Snapshots
+ * from other threads read them without locking the container.
+ */
+class monitor_entry {
+public:
+	monitor_entry(std::string name, const char* kind, std::size_t capacity)
+		: m_name(std::move(name))
+		, m_kind(kind)
+		, m_capacity(capacity)
+		, m_size(0)
+		, m_high_water(0)
+		, m_pushes(0)
+		, m_pops(0)
+		, m_full(0)
+		, m_last_pushes(0)
+		, m_last_pops(0)
+		, m_last_time(std::chrono::steady_clock::now())
+	{}
+
+	monitor_entry(const monitor_entry&) = delete;
+	monitor_entry& operator=(const monitor_entry&) = delete;
+
+	const std::string& name() const noexcept
+	{
+		return m_name;
+	}
+
+protected:
+	friend class registry;
+	template <typename Monitored>
+	friend struct detail::monitor_trace;
+
+	// Only the owner writes, so a load and a store do, without a locked instruction
+	static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t n) noexcept
+	{
+		const std::uint64_t v = counter.load(std::memory_order_relaxed);
+		counter.store(v + n, std::memory_order_relaxed);
+	}
+
+	void on_push(std::size_t n, std::size_t size) noexcept
+	{
+		increment(m_pushes, n);
+		m_size.store(size, std::memory_order_relaxed);
+		if(size > m_high_water.load(std::memory_order_relaxed))
+			m_high_water.store(size, std::memory_order_relaxed);
+	}
+
+	void on_pop(std::size_t n, std::size_t size) noexcept
+	{
+		increment(m_pops, n);
+		m_size.store(size, std::memory_order_relaxed);
+	}
+
+	void on_full() noexcept
+	{
+		increment(m_full, 1);
+	}
+
+	std::string m_name;
+	const char* m_kind;
+	std::size_t m_capacity;
+	std::atomic<std::size_t> m_size;
+	std::atomic<std::size_t> m_high_water;
+	std::atomic<std::uint64_t> m_pushes;
+	std::atomic<std::uint64_t> m_pops;
+	std::atomic<std::uint64_t> m_full;
+
+	// State of the previous snapshot, for the rates; guarded by the registry
+	std::uint64_t m_last_pushes;
+	std::uint64_t m_last_pops;
+	std::chrono::steady_clock::time_point m_last_time;
+};
+
+/**
+ * Process-wide list of monitored containers, for a snapshot of all of them at once.
+ *
+ * Containers join by being declared as `cc::monitored`, and leave when destroyed. Containers
+ * that are not monitored are not affected in any way.
+ *
+ * @code
+ * cc::monitored<cc::fifo, packet, 1024> ingress("ingress");
+ * ...
+ * // Every few seconds, for the node_exporter textfile collector:
+ * cc::registry::instance().write("/var/lib/node_exporter/queues.prom");
+ * @endcode
+ */
+class registry {
+public:
+	enum class format { prometheus, json };
+
+	static registry& instance()
+	{
+		static registry r;
+		return r;
+	}
+
+	void add(monitor_entry* e)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_entries.push_back(e);
+	}
+
+	void remove(monitor_entry* e)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto last = std::remove(m_entries.begin(), m_entries.end(), e);
+		m_entries.erase(last, m_entries.end());
+	}
+
+	std::size_t size()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_entries.size();
+	}
+
+	/**
+	 * Get the stats of all monitored containers, in order of registration. The rates cover
+	 * the time since the previous snapshot (or since registration).
+	 */
+	std::vector<container_stats> snapshot()
+	{
+		const auto now = std::chrono::steady_clock::now();
+		std::vector<container_stats> out;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		out.reserve(m_entries.size());
+		for(monitor_entry* e : m_entries) {
+			container_stats s;
+			s.name = e->m_name;
+			s.kind = e->m_kind;
+			s.capacity = e->m_capacity;
+			s.size = e->m_size.load(std::memory_order_relaxed);
+			s.high_water = e->m_high_water.load(std::memory_order_relaxed);
+			s.pushes = e->m_pushes.load(std::memory_order_relaxed);
+			s.pops = e->m_pops.load(std::memory_order_relaxed);
+			s.full = e->m_full.load(std::memory_order_relaxed);
+
+			const std::chrono::duration<double> dt = now - e->m_last_time;
+			const double hz = dt.count() > 0 ? 1 / dt.count() : 0;
+			s.push_rate = static_cast<double>(s.pushes - e->m_last_pushes) * hz;
+			s.pop_rate = static_cast<double>(s.pops - e->m_last_pops) * hz;
+			e->m_last_pushes = s.pushes;
+			e->m_last_pops = s.pops;
+			e->m_last_time = now;
+			out.push_back(std::move(s));
+		}
+		return out;
+	}
+
+	/**
+	 * Write stats in the Prometheus text exposition format.
+	 */
+	static void write_prometheus(std::ostream& os, const std::vector<container_stats>& stats)
+	{
+		const struct {
+			const char* name;
+			const char* type;
+			const char* help;
+		} metrics[] = {
+			{"cc_container_capacity", "gauge", "Maximum number of elements."},
+			{"cc_container_size", "gauge", "Current number of elements."},
+			{"cc_container_high_water", "gauge", "Largest number of elements reached."},
+			{"cc_container_pushes_total", "counter", "Elements pushed."},
+			{"cc_container_pops_total", "counter", "Elements popped."},
+			{"cc_container_full_total", "counter", "Pushes that filled the container."},
+		};
+
+		for(std::size_t m = 0; m < std::size(metrics); m++) {
+			os << "# HELP " << metrics[m].name << ' ' << metrics[m].help << '\n';
+			os << "# TYPE " << metrics[m].name << ' ' << metrics[m].type << '\n';
+			for(const container_stats& s : stats) {
+				const std::uint64_t values[] = {s.capacity, s.size,  s.high_water,
+								s.pushes,   s.pops, s.full};
+				os << metrics[m].name << "{name=\"";
+				write_escaped(os, s.name);
+				os << "\",kind=\"" << s.kind << "\"} " << values[m] << '\n';
+			}
+		}
+	}
+
+	/**
+	 * Write stats as a JSON array of objects, one per container.
+	 */
+	static void write_json(std::ostream& os, const std::vector<container_stats>& stats)
+	{
+		os << '[';
+		for(std::size_t i = 0; i < stats.size(); i++) {
+			const container_stats& s = stats[i];
+			os << (i ? ",\n " : "\n ") << "{\"name\": \"";
+			write_escaped(os, s.name);
+			os << "\", \"kind\": \"" << s.kind << "\", \"capacity\": " << s.capacity
+			   << ", \"size\": " << s.size << ", \"high_water\": " << s.high_water
+			   << ", \"pushes\": " << s.pushes << ", \"pops\": " << s.pops
+			   << ", \"full\": " << s.full << ", \"push_rate\": " << s.push_rate
+			   << ", \"pop_rate\": " << s.pop_rate << '}';
+		}
+		os << (stats.empty() ? "]\n" : "\n]\n");
+	}
+
+	/**
+	 * Take a snapshot and write it to a local file. The file is written next to `path` and
+	 * renamed over it, so readers never see a partial dump.
+	 */
+	void write(const std::string& path, format f = format::prometheus)
+	{
+		const std::vector<container_stats> stats = snapshot();
+		const std::string tmp = path + ".tmp";
+		{
+			std::ofstream os(tmp, std::ios::trunc);
+			if(f == format::prometheus)
+				write_prometheus(os, stats);
+			else
+				write_json(os, stats);
+			os.flush();
+			if(!os)
+				std::__throw_runtime_error("registry::write"); // Cannot write file
+		}
+		if(std::rename(tmp.c_str(), path.c_str()) != 0)
+			std::__throw_runtime_error("registry::write"); // Cannot replace file
+	}
+
+protected:
+	registry() = default;
+
+	/**
+	 * Write a name with quotes, backslashes and control characters escaped, which is valid
+	 * for both Prometheus label values and JSON strings.
+	 */
+	static void write_escaped(std::ostream& os, const std::string& s)
+	{
+		for(char c : s) {
+			if(c == '"' || c == '\\')
+				os << '\\' << c;
+			else if(c == '\n')
+				os << "\\n";
+			else if(static_cast<unsigned char>(c) >= 0x20)
+				os << c;
+		}
+	}
+
+	std::mutex m_mutex;
+	std::vector<monitor_entry*> m_entries;
+};
+
+namespace detail {
+
+/**
+ * Trace policy of `cc::monitored`, which forwards the events to its counters.
+ */
+template <typename Monitored>
+struct monitor_trace {
+	static constexpr bool enabled = true;
+
+	template <typename Container>
+	static void push(const char*, const Container* self, std::size_t n, std::size_t size)
+	{
+		entry(self).on_push(n, size);
+	}
+
+	template <typename Container>
+	static void pop(const char*, const Container* self, std::size_t n, std::size_t size)
+	{
+		entry(self).on_pop(n, size);
+	}
+
+	template <typename Container>
+	static void full(const char*, const Container* self, std::size_t)
+	{
+		entry(self).on_full();
+	}
+
+	template <typename Container>
+	static void empty(const char*, const Container*)
+	{}
+
+	// The hooks get the container const, but the counters are not part of its value
+	template <typename Container>
+	static monitor_entry& entry(const Container* self)
+	{
+		return const_cast<Monitored&>(static_cast<const Monitored&>(*self));
+	}
+};
+
+} // namespace detail
+
+/**
+ * A `cc::buffer` or `cc::fifo` that reports its occupancy to the `cc::registry`.
+ *
+ * Its trace policy (see trace.hxx) updates the counters, so it counts exactly the events that
+ * a trace would see. It is still a `cc::buffer` or `cc::fifo`, and works with all functions
+ * that take one.
+ *
+ * @code
+ * cc::monitored<cc::fifo, float, 4096> samples("adc0.samples");
+ * samples.push(1.0f);
+ * @endcode
+ *
+ * @tparam Container `cc::buffer` or `cc::fifo`
+ * @tparam Tp Type of each element
+ * @tparam Nm Capacity
+ */
+template <template <typename, std::size_t, typename> class Container, typename Tp, std::size_t Nm>
+class monitored : public Container<Tp, Nm, detail::monitor_trace<monitored<Container, Tp, Nm>>>,
+		  public monitor_entry {
+public:
+	typedef Container<Tp, Nm, detail::monitor_trace<monitored>> container_type;
+
+	explicit monitored(std::string name)
+		: monitor_entry(std::move(name), kind(), Nm)
+	{
+		registry::instance().add(this);
+	}
+
+	~monitored()
+	{
+		registry::instance().remove(this);
+	}
+
+protected:
+	static constexpr const char* kind()
+	{
+		if constexpr(std::is_same<container_type,
+					  fifo<Tp, Nm, detail::monitor_trace<monitored>>>::value)
+			return "fifo";
+		else
+			return "buffer";
+	}
+};
+
+} // namespace cc
+
+#endif /* REGISTRY_H */
@@ -0,0 +1,225 @@
+#ifndef ROW_RING_H
+#define ROW_RING_H
+
+#include <algorithm>
+#include <array>
+
+namespace cc {
+
+/**
+ * Ring of the last `Rows` rows of a two-dimensional stream, like image lines or spectra.
+ *
+ * Rows are written in place, so pushing a row costs no copy, and a new row replaces the oldest
+ * once the ring is full. Every row starts on a cache line and is padded to a whole number of
+ * cache lines (for element sizes that divide it).
+ *
+ * Any window of consecutive rows is available as a contiguous table of row pointers, oldest
+ * first, so stencil and filter kernels can index `rows[k][x]` without copying. The table is
+ * kept twice in a row, such that a window that wraps around the ring is still contiguous.
+ *
+ * @code
+ * cc::row_ring<float, 1024, 8> lines;
+ * camera.read(lines.push());
+ * if(lines.size() >= 3) {
+ *         const float* const* w = lines.window(lines.size() - 3, 3);
+ *         blur3x3(w[0], w[1], w[2], out, 1024);
+ * }
+ * @endcode
+ *
+ * @tparam Tp Type of each element
+ * @tparam Width Number of elements per row
+ * @tparam Rows Number of rows kept
+ */
+template <typename Tp, std::size_t Width, std::size_t Rows>
+class row_ring {
+	static_assert(Width > 0 && Rows > 0, "Empty row ring");
+
+public:
+	typedef Tp value_type;
+
+	static constexpr std::size_t cache_line = 64;
+	// Elements per cache line, or 1 if they don't divide it (no padding then)
+	static constexpr std::size_t line = cache_line % sizeof(Tp) ? 1 : cache_line / sizeof(Tp);
+	// Elements per row, including padding
+	static constexpr std::size_t stride = (Width + line - 1) / line * line;
+
+	row_ring()
+		: m_first(0)
+		, m_size(0)
+	{
+		link();
+	}
+
+	row_ring(const row_ring& other)
+		: m_data(other.m_data)
+		, m_first(other.m_first)
+		, m_size(other.m_size)
+	{
+		link();
+	}
+
+	row_ring& operator=(const row_ring& other)
+	{
+		// The pointer table refers to our own storage, so it stays as is
+		m_data = other.m_data;
+		m_first = other.m_first;
+		m_size = other.m_size;
+		return *this;
+	}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Remove all rows (memory is not actually overwritten).
+	 */
+	void truncate()
+	{
+		m_first = 0;
+		m_size = 0;
+	}
+
+	/**
+	 * Get the number of rows.
+	 */
+	std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	bool full() const noexcept
+	{
+		return m_size == Rows;
+	}
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return Rows;
+	}
+
+	static constexpr std::size_t width() noexcept
+	{
+		return Width;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	/**
+	 * Add a row, dropping the oldest one when full.
+	 *
+	 * @return The new row, to be filled in by the caller (its contents are stale)
+	 */
+	value_type* push() noexcept
+	{
+		if(full())
+			m_first = m_first + 1 == Rows ? 0 : m_first + 1;
+		else
+			m_size++;
+		return m_rows[m_first + m_size - 1];
+	}
+
+	/**
+	 * Add a copy of `Width` elements as a row, dropping the oldest one when full.
+	 */
+	void push(const value_type* row)
+	{
+		std::copy(row, row + Width, push());
+	}
+
+	/**
+	 * Remove the oldest row.
+	 */
+	void pop()
+	{
+		if(empty())
+			std::__throw_out_of_range("row_ring::pop"); // No rows left
+		m_first = m_first + 1 == Rows ? 0 : m_first + 1;
+		m_size--;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get row `n`, counting from the oldest (without checking the size).
+	 */
+	value_type* operator[](std::size_t n) noexcept
+	{
+		return m_rows[m_first + n];
+	}
+
+	const value_type* operator[](std::size_t n) const noexcept
+	{
+		return m_rows[m_first + n];
+	}
+
+	/**
+	 * Get the newest row.
+	 */
+	value_type* back()
+	{
+		if(empty())
+			std::__throw_out_of_range("row_ring::back");
+		return m_rows[m_first + m_size - 1];
+	}
+
+	const value_type* back() const
+	{
+		if(empty())
+			std::__throw_out_of_range("row_ring::back");
+		return m_rows[m_first + m_size - 1];
+	}
+
+	/**
+	 * Get a table of `n` consecutive row pointers, starting at row `first` from the oldest.
+	 *
+	 * The table stays valid, but it refers to different rows after the next push() or pop().
+	 */
+	value_type* const* window(std::size_t first, std::size_t n)
+	{
+		if(first + n > m_size)
+			std::__throw_out_of_range("row_ring::window");
+		return m_rows.data() + m_first + first;
+	}
+
+	const value_type* const* window(std::size_t first, std::size_t n) const
+	{
+		if(first + n > m_size)
+			std::__throw_out_of_range("row_ring::window");
+		return m_rows.data() + m_first + first;
+	}
+
+	/* @} */
+
+protected:
+	void link() noexcept
+	{
+		for(std::size_t i = 0; i < 2 * Rows; i++)
+			m_rows[i] = m_data.data() + (i % Rows) * stride;
+	}
+
+	alignas(cache_line) std::array<Tp, stride * Rows> m_data;
+	std::array<Tp*, 2 * Rows> m_rows; // Row pointers, twice, such that windows never wrap
+	std::size_t m_first; // Slot of the oldest row
+	std::size_t m_size; // Number of rows
+};
+
+} // namespace cc
+
+#endif /* ROW_RING_H */
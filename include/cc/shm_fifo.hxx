@@ -0,0 +1,230 @@
+#ifndef SHM_FIFO_H
+#define SHM_FIFO_H
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "shm_queue.h"
+
+namespace cc {
+
+/**
+ * Single-producer single-consumer fifo living in (shared) memory that is owned elsewhere.
+ *
+ * The memory layout is the C ABI of `shm_queue.h`, so the other end of the queue can be written
+ * in any language. This class only holds a pointer to that memory; copying it gives a second
+ * handle to the same queue. One thread or process may push, and one other may pop.
+ *
+ * The memory must be aligned to at least `alignof(Tp)`, but preferably to a cache line.
+ *
+ * @code
+ * void* mem = mmap(nullptr, cc::shm_fifo<sample, 4096>::bytes(), ...);
+ * auto q = cc::shm_fifo<sample, 4096>::create(mem, cc::shm_fifo<sample, 4096>::bytes());
+ * q.push(s);
+ * @endcode
+ *
+ * @tparam Tp Type of each element, must be trivially copyable
+ * @tparam Nm Number of items that fit in the fifo until full
+ */
+template <typename Tp, std::size_t Nm>
+class shm_fifo {
+	static_assert(std::is_trivially_copyable<Tp>::value, "Can only share plain data");
+	static_assert(Nm > 0, "Capacity must be positive");
+
+public:
+	typedef Tp value_type;
+
+	/**
+	 * Number of bytes of memory needed for this queue.
+	 */
+	static constexpr std::size_t bytes() noexcept
+	{
+		return sizeof(cc_shm_queue) + Nm * sizeof(Tp);
+	}
+
+	/**
+	 * Initialize a new, empty queue in the given memory.
+	 */
+	static shm_fifo create(void* memory, std::size_t size)
+	{
+		if(cc_shm_queue_init(memory, size, Nm, sizeof(Tp)))
+			std::__throw_invalid_argument("shm_fifo::create");
+		return shm_fifo(static_cast<cc_shm_queue*>(memory));
+	}
+
+	/**
+	 * Use a queue that was created before, possibly by another process.
+	 */
+	static shm_fifo attach(void* memory, std::size_t size)
+	{
+		if(cc_shm_queue_check(memory, size, sizeof(Tp))
+		   || static_cast<cc_shm_queue*>(memory)->capacity != Nm)
+			std::__throw_invalid_argument("shm_fifo::attach"); // Incompatible queue
+		return shm_fifo(static_cast<cc_shm_queue*>(memory));
+	}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return Nm;
+	}
+
+	/**
+	 * Get current active size.
+	 *
+	 * When called from the producer, the actual size may be smaller, and from the consumer it
+	 * may be larger.
+	 */
+	std::size_t size() const noexcept
+	{
+		return static_cast<std::size_t>(cc_shm_queue_size(m_queue));
+	}
+
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	std::size_t free() const noexcept
+	{
+		return max_size() - size();
+	}
+
+	bool full() const noexcept
+	{
+		return size() == max_size();
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	/**
+	 * Producer: append an element.
+	 */
+	void push(const value_type& v)
+	{
+		if(!try_push(v))
+			std::__throw_out_of_range("shm_fifo::push"); // No space left
+	}
+
+	bool try_push(const value_type& v)
+	{
+		return cc_shm_queue_push(m_queue, &v) == 0;
+	}
+
+	/**
+	 * Producer: append multiple elements, with a single update of the shared head.
+	 */
+	void push_list(const value_type* other_begin, const value_type* other_end)
+	{
+		const std::size_t n = static_cast<std::size_t>(other_end - other_begin);
+		if(free() < n)
+			std::__throw_out_of_range("shm_fifo::push_list"); // Not enough space left
+
+		const std::uint64_t head = __atomic_load_n(&m_queue->head, __ATOMIC_RELAXED);
+		const std::size_t slot = static_cast<std::size_t>(head % Nm);
+		const std::size_t n1 = std::min(n, Nm - slot);
+		std::memcpy(data() + slot, other_begin, n1 * sizeof(Tp));
+		std::memcpy(data(), other_begin + n1, (n - n1) * sizeof(Tp));
+		__atomic_store_n(&m_queue->head, head + n, __ATOMIC_RELEASE);
+	}
+
+	/**
+	 * Consumer: remove the oldest element.
+	 */
+	value_type pop()
+	{
+		value_type v;
+		if(!try_pop(v))
+			std::__throw_out_of_range("shm_fifo::pop"); // No items left
+		return v;
+	}
+
+	bool try_pop(value_type& v)
+	{
+		return cc_shm_queue_pop(m_queue, &v) == 0;
+	}
+
+	/**
+	 * Consumer: remove multiple elements, with a single update of the shared tail.
+	 *
+	 * @param n Number of items - Default: take all available items
+	 */
+	void pop_list(value_type* other_begin, std::size_t n = 0)
+	{
+		const std::size_t available = size();
+		if(n > available)
+			std::__throw_out_of_range("shm_fifo::pop_list"); // Not enough items left
+		else if(n == 0)
+			n = available;
+
+		const std::uint64_t tail = __atomic_load_n(&m_queue->tail, __ATOMIC_RELAXED);
+		const std::size_t slot = static_cast<std::size_t>(tail % Nm);
+		const std::size_t n1 = std::min(n, Nm - slot);
+		std::memcpy(other_begin, data() + slot, n1 * sizeof(Tp));
+		std::memcpy(other_begin + n1, data(), (n - n1) * sizeof(Tp));
+		__atomic_store_n(&m_queue->tail, tail + n, __ATOMIC_RELEASE);
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Segment access
+	 *
+	 * Consumer: read the oldest elements in place, then discard() them.
+	 */
+	/* @{ */
+
+	/**
+	 * Get the oldest elements that are stored contiguously.
+	 *
+	 * @return Number of elements from `first` onwards, 0 when empty
+	 */
+	std::size_t peek(const value_type*& first) const noexcept
+	{
+		const void* p = nullptr;
+		const std::size_t n = static_cast<std::size_t>(cc_shm_queue_peek(m_queue, &p));
+		first = static_cast<const value_type*>(p);
+		return n;
+	}
+
+	void discard(std::size_t n)
+	{
+		if(n > size())
+			std::__throw_out_of_range("shm_fifo::discard"); // Not enough items left
+		cc_shm_queue_release(m_queue, n);
+	}
+
+	/* @} */
+
+	cc_shm_queue* header() const noexcept
+	{
+		return m_queue;
+	}
+
+protected:
+	explicit shm_fifo(cc_shm_queue* queue)
+		: m_queue(queue)
+	{}
+
+	value_type* data() const noexcept
+	{
+		return static_cast<value_type*>(cc_shm_queue_data(m_queue));
+	}
+
+	cc_shm_queue* m_queue;
+};
+
+} // namespace cc
+
+#endif /* SHM_FIFO_H */
@@ -0,0 +1,211 @@
+#ifndef CC_SHM_QUEUE_H
+#define CC_SHM_QUEUE_H
+
+/*
+ * Fixed-layout single-producer single-consumer queue in shared memory.
+ *
+ * This is plain C, so any runtime that can map the memory and do atomic 64-bit loads and stores
+ * can produce into or consume from the same queue in place. The C++ interface is cc::shm_fifo in
+ * shm_fifo.hxx.
+ *
+ * Layout (all fields little-endian, as on the host):
+ *
+ *   offset   0  header: magic, version, capacity, element size, data offset
+ *   offset  64  head: number of elements ever pushed, only written by the producer
+ *   offset 128  tail: number of elements ever popped, only written by the consumer
+ *   offset 192  data: capacity * element_size bytes
+ *
+ * Like cc::fifo, size = head - tail, and the element with sequence number i lives in slot
+ * i % capacity. head and tail only ever increase, so they never wrap in practice.
+ *
+ * head and tail must be accessed atomically: the producer stores head with release semantics
+ * after writing an element, the consumer loads it with acquire semantics before reading one,
+ * and vice versa for tail. The helpers below use the GCC/Clang __atomic builtins.
+ *
+ * The version is bumped on any incompatible change of this layout.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define CC_SHM_QUEUE_MAGIC	0x51464343u /* "CCFQ" */
+#define CC_SHM_QUEUE_VERSION	1u
+#define CC_SHM_QUEUE_CACHE_LINE 64u
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cc_shm_queue {
+	/* Written once by cc_shm_queue_init() */
+	uint32_t magic;
+	uint32_t version;
+	uint64_t capacity;     /* Number of elements */
+	uint64_t element_size; /* Bytes per element */
+	uint64_t data_offset;  /* Bytes from the start of this struct to the data */
+	uint8_t reserved0[CC_SHM_QUEUE_CACHE_LINE - 32];
+
+	/* Owned by the producer */
+	uint64_t head;
+	uint8_t reserved1[CC_SHM_QUEUE_CACHE_LINE - 8];
+
+	/* Owned by the consumer */
+	uint64_t tail;
+	uint8_t reserved2[CC_SHM_QUEUE_CACHE_LINE - 8];
+} cc_shm_queue;
+
+#ifdef __cplusplus
+#	define CC_SHM_QUEUE_STATIC_ASSERT(expr, msg) static_assert(expr, msg)
+#else
+#	define CC_SHM_QUEUE_STATIC_ASSERT(expr, msg) _Static_assert(expr, msg)
+#endif
+
+CC_SHM_QUEUE_STATIC_ASSERT(offsetof(cc_shm_queue, capacity) == 8, "Unexpected layout");
+CC_SHM_QUEUE_STATIC_ASSERT(offsetof(cc_shm_queue, head) == 64, "Unexpected layout");
+CC_SHM_QUEUE_STATIC_ASSERT(offsetof(cc_shm_queue, tail) == 128, "Unexpected layout");
+CC_SHM_QUEUE_STATIC_ASSERT(sizeof(cc_shm_queue) == 192, "Unexpected layout");
+
+/*
+ * Whether a data region of capacity elements of element_size bytes, starting at data_offset
+ * after a header, fits in bytes. Computed without overflow, as the values may be corrupt.
+ */
+static inline int
+cc_shm_queue_fits(size_t bytes, uint64_t data_offset, uint64_t capacity, uint64_t element_size)
+{
+	return capacity != 0 && element_size != 0 && data_offset >= sizeof(cc_shm_queue)
+	       && data_offset <= bytes && capacity <= (bytes - data_offset) / element_size;
+}
+
+/* Number of bytes of shared memory needed for a queue, or SIZE_MAX if that overflows. */
+static inline size_t cc_shm_queue_bytes(uint64_t capacity, uint64_t element_size)
+{
+	if(element_size && capacity > (SIZE_MAX - sizeof(cc_shm_queue)) / element_size)
+		return SIZE_MAX;
+	return sizeof(cc_shm_queue) + (size_t)(capacity * element_size);
+}
+
+/*
+ * Initialize a new, empty queue in the given memory.
+ *
+ * The magic is written last, so a peer that checks it sees a complete header.
+ * Returns 0 on success, -1 if the memory is too small or the parameters are invalid.
+ */
+static inline int
+cc_shm_queue_init(void* mem, size_t bytes, uint64_t capacity, uint64_t element_size)
+{
+	cc_shm_queue* q = (cc_shm_queue*)mem;
+
+	if(!mem || !cc_shm_queue_fits(bytes, sizeof(cc_shm_queue), capacity, element_size))
+		return -1;
+
+	memset(q, 0, sizeof(*q));
+	q->version = CC_SHM_QUEUE_VERSION;
+	q->capacity = capacity;
+	q->element_size = element_size;
+	q->data_offset = sizeof(cc_shm_queue);
+	__atomic_store_n(&q->magic, CC_SHM_QUEUE_MAGIC, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/*
+ * Check that the memory holds a compatible queue, with a header that cannot make the other
+ * functions divide by zero or access memory outside of bytes.
+ *
+ * Pass element_size 0 to accept any element size.
+ * Returns 0 when the queue can be used, -1 otherwise.
+ */
+static inline int cc_shm_queue_check(const void* mem, size_t bytes, uint64_t element_size)
+{
+	const cc_shm_queue* q = (const cc_shm_queue*)mem;
+
+	if(!mem || bytes < sizeof(cc_shm_queue)
+	   || __atomic_load_n(&q->magic, __ATOMIC_ACQUIRE) != CC_SHM_QUEUE_MAGIC
+	   || q->version != CC_SHM_QUEUE_VERSION
+	   || (element_size && q->element_size != element_size)
+	   || !cc_shm_queue_fits(bytes, q->data_offset, q->capacity, q->element_size))
+		return -1;
+
+	return 0;
+}
+
+static inline void* cc_shm_queue_data(cc_shm_queue* q)
+{
+	return (char*)q + q->data_offset;
+}
+
+static inline uint64_t cc_shm_queue_size(const cc_shm_queue* q)
+{
+	/* Load tail first; head can only grow meanwhile, so the result never underflows. */
+	uint64_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+	uint64_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+	return head - tail;
+}
+
+/*
+ * Producer: append one element of element_size bytes.
+ * Returns 0 on success, -1 when the queue is full.
+ */
+static inline int cc_shm_queue_push(cc_shm_queue* q, const void* element)
+{
+	uint64_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+	uint64_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+
+	if(head - tail >= q->capacity)
+		return -1;
+
+	memcpy((char*)cc_shm_queue_data(q) + (head % q->capacity) * q->element_size, element,
+	       (size_t)q->element_size);
+	__atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/*
+ * Consumer: get the oldest elements in place, without removing them.
+ *
+ * Sets *first to the oldest element and returns how many elements follow contiguously from
+ * there (at most up to the end of the data region). Returns 0 when the queue is empty.
+ * Call cc_shm_queue_release() when done with them.
+ */
+static inline uint64_t cc_shm_queue_peek(cc_shm_queue* q, const void** first)
+{
+	uint64_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+	uint64_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+	uint64_t slot = tail % q->capacity;
+	uint64_t n = head - tail;
+
+	if(n > q->capacity - slot)
+		n = q->capacity - slot;
+
+	*first = (const char*)cc_shm_queue_data(q) + slot * q->element_size;
+	return n;
+}
+
+/* Consumer: remove n elements, as returned by cc_shm_queue_peek(). */
+static inline void cc_shm_queue_release(cc_shm_queue* q, uint64_t n)
+{
+	uint64_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+	__atomic_store_n(&q->tail, tail + n, __ATOMIC_RELEASE);
+}
+
+/*
+ * Consumer: copy out and remove the oldest element.
+ * Returns 0 on success, -1 when the queue is empty.
+ */
+static inline int cc_shm_queue_pop(cc_shm_queue* q, void* element)
+{
+	const void* first;
+
+	if(cc_shm_queue_peek(q, &first) == 0)
+		return -1;
+
+	memcpy(element, first, (size_t)q->element_size);
+	cc_shm_queue_release(q, 1);
+	return 0;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CC_SHM_QUEUE_H */
@@ -0,0 +1,227 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "buffer.hxx"
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Unsigned integer whose order matches the order of `Tp`, for integers and floating point.
+ *
+ * Floats are ordered like their total order: -NaN < -inf < ... < -0 < +0 < ... < +inf < +NaN.
+ */
+template <typename Tp>
+struct radix_key {
+	static_assert(
+		(std::is_integral<Tp>::value && !std::is_same<Tp, bool>::value)
+			|| std::is_same<Tp, float>::value || std::is_same<Tp, double>::value,
+		"Only integers, float and double can be radix sorted");
+
+	typedef std::conditional_t<
+		sizeof(Tp) == 1,
+		std::uint8_t,
+		std::conditional_t<
+			sizeof(Tp) == 2,
+			std::uint16_t,
+			std::conditional_t<sizeof(Tp) == 4, std::uint32_t, std::uint64_t>>>
+		type;
+
+	static constexpr type sign = type(1) << (sizeof(type) * 8 - 1);
+
+	static type encode(Tp v) noexcept
+	{
+		type k;
+		std::memcpy(&k, &v, sizeof(k));
+		if constexpr(std::is_floating_point<Tp>::value)
+			return (k & sign) ? type(~k) : type(k | sign);
+		else if constexpr(std::is_signed<Tp>::value)
+			return type(k ^ sign);
+		else
+			return k;
+	}
+
+	static Tp decode(type k) noexcept
+	{
+		if constexpr(std::is_floating_point<Tp>::value)
+			k = (k & sign) ? type(k ^ sign) : type(~k);
+		else if constexpr(std::is_signed<Tp>::value)
+			k = type(k ^ sign);
+		Tp v;
+		std::memcpy(&v, &k, sizeof(v));
+		return v;
+	}
+};
+
+/**
+ * Comparators of Batcher's odd-even merge sort for `n` elements.
+ *
+ * The network for the next power of two is used, without the comparators that touch elements
+ * beyond `n`: those would compare against +infinity padding, which never moves.
+ *
+ * @param out Output for the pairs, or nullptr to only count them
+ * @return Number of comparators
+ */
+constexpr std::size_t odd_even_merge_network(std::size_t n, std::array<std::uint16_t, 2>* out)
+{
+	std::size_t p2 = 1;
+	while(p2 < n)
+		p2 *= 2;
+
+	std::size_t count = 0;
+	for(std::size_t p = 1; p < p2; p *= 2)
+		for(std::size_t k = p; k >= 1; k /= 2)
+			for(std::size_t j = k % p; j + k < p2; j += 2 * k)
+				for(std::size_t i = 0; i < k && i + j + k < p2; i++) {
+					const std::size_t a = i + j;
+					const std::size_t b = i + j + k;
+					if(a / (2 * p) != b / (2 * p) || b >= n)
+						continue;
+					if(out)
+						out[count] = {{std::uint16_t(a), std::uint16_t(b)}};
+					count++;
+				}
+	return count;
+}
+
+template <std::size_t N>
+constexpr std::array<std::array<std::uint16_t, 2>, odd_even_merge_network(N, nullptr)>
+make_sorting_network()
+{
+	std::array<std::array<std::uint16_t, 2>, odd_even_merge_network(N, nullptr)> net{};
+	odd_even_merge_network(N, net.data());
+	return net;
+}
+
+template <std::size_t N>
+inline constexpr auto sorting_network = make_sorting_network<N>();
+
+template <typename Key>
+inline void compare_exchange(Key& a, Key& b) noexcept
+{
+	const Key x = a;
+	a = std::min(x, b);
+	b = std::max(x, b);
+}
+
+/**
+ * Run the network for `N` keys, fully unrolled. Comparators are branch-free min/max pairs.
+ */
+template <std::size_t N, typename Key, std::size_t... I>
+inline void run_sorting_network([[maybe_unused]] Key* k, std::index_sequence<I...>) noexcept
+{
+	(compare_exchange(k[sorting_network<N>[I][0]], k[sorting_network<N>[I][1]]), ...);
+}
+
+} // namespace detail
+
+/**
+ * @defgroup Sorting
+ *
+ * Ascending sorts for buffers of integers, float and double, that don't allocate. Floats are
+ * sorted in their total order, so -0 comes before +0, and (positive) NaNs come last.
+ */
+/* @{ */
+
+/**
+ * Sort the used elements of a buffer with a sorting network for its capacity.
+ *
+ * The network is built at compile time for `Nm` elements and fully unrolled; unused elements
+ * are padded. Meant for small capacities (up to around 64).
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+void network_sort(buffer<Tp, Nm, Trace>& b)
+{
+	static_assert(Nm <= 256, "Sorting network is too large, use radix_sort()");
+	typedef detail::radix_key<Tp> key;
+
+	std::array<typename key::type, Nm> k;
+	for(std::size_t i = 0; i < b.size(); i++)
+		k[i] = key::encode(b[i]);
+	std::fill(k.begin() + b.size(), k.end(), std::numeric_limits<typename key::type>::max());
+
+	constexpr std::size_t comparators = detail::sorting_network<Nm>.size();
+	detail::run_sorting_network<Nm>(k.data(), std::make_index_sequence<comparators>());
+
+	for(std::size_t i = 0; i < b.size(); i++)
+		b[i] = key::decode(k[i]);
+}
+
+/**
+ * Sort the used elements of a buffer with an LSD radix sort, 8 bits per pass.
+ *
+ * The histograms of all passes are counted in a single pass over the data, and passes in
+ * which all elements share the same digit are skipped.
+ *
+ * @param scratch Buffer for the intermediate passes, its contents are overwritten
+ */
+template <typename Tp, std::size_t Nm, typename Trace, typename Trace2>
+void radix_sort(buffer<Tp, Nm, Trace>& b, buffer<Tp, Nm, Trace2>& scratch)
+{
+	typedef detail::radix_key<Tp> key;
+	constexpr std::size_t passes = sizeof(Tp);
+	const std::size_t n = b.size();
+
+	std::array<std::array<std::size_t, 256>, passes> counts{};
+	for(std::size_t i = 0; i < n; i++) {
+		const auto k = key::encode(b[i]);
+		for(std::size_t p = 0; p < passes; p++)
+			counts[p][(k >> (8 * p)) & 0xFFu]++;
+	}
+
+	Tp* src = b.data();
+	Tp* dst = scratch.data();
+	for(std::size_t p = 0; p < passes; p++) {
+		auto& count = counts[p];
+		if(std::find(count.begin(), count.end(), n) != count.end())
+			continue; // All elements have the same digit
+
+		std::size_t offset = 0;
+		for(auto& c : count) {
+			const std::size_t c0 = c;
+			c = offset;
+			offset += c0;
+		}
+		for(std::size_t i = 0; i < n; i++) {
+			const Tp v = src[i];
+			dst[count[(key::encode(v) >> (8 * p)) & 0xFFu]++] = v;
+		}
+		std::swap(src, dst);
+	}
+
+	if(src != b.data())
+		std::copy(src, src + n, b.data());
+	scratch.reset(n);
+}
+
+/**
+ * Sort the used elements of a buffer, selecting the method by capacity.
+ *
+ * Up to 64 elements use network_sort(), larger buffers use radix_sort() with a scratch buffer
+ * on the stack. For large capacities, call radix_sort() with your own scratch buffer instead.
+ */
+template <typename Tp, std::size_t Nm, typename Trace>
+void sort(buffer<Tp, Nm, Trace>& b)
+{
+	if constexpr(Nm <= 64) {
+		network_sort(b);
+	} else {
+		buffer<Tp, Nm, no_trace> scratch; // Internal, never traced
+		radix_sort(b, scratch);
+	}
+}
+
+/* @} */
+
+} // namespace cc
+
+#endif /* SORT_H */
@@ -0,0 +1,190 @@
+#ifndef TIMED_FIFO_H
+#define TIMED_FIFO_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "clock.hxx"
+#include "fifo.hxx"
+#include "hdr_histogram.hxx"
+
+namespace cc {
+
+/**
+ * First-in, first-out buffer that stamps each element when pushed, and records how long it sat
+ * in the queue (its sojourn time) when popped.
+ *
+ * The stamps are kept in a second fifo next to the values, in lockstep. A batch push reads the
+ * clock once for all its elements. The sojourn times are recorded in nanoseconds, in sojourn().
+ *
+ * @code
+ * cc::timed_fifo<packet, 1024, cc::tsc_clock> queue;
+ * ...
+ * report("p99 queueing", queue.sojourn().value_at_percentile(99));
+ * @endcode
+ *
+ * @tparam Tp Type of each element
+ * @tparam Nm Number of items that fit in the fifo until full
+ * @tparam Clock Clock for the stamps, see clock.hxx
+ * @tparam Histogram Histogram of the sojourn times in nanoseconds; by default up to a minute,
+ *         to two significant digits (30 KiB)
+ */
+template <typename Tp, std::size_t Nm, typename Clock = coarse_clock,
+	  typename Histogram = hdr_histogram<60000000000, 2>>
+class timed_fifo {
+public:
+	typedef Tp value_type;
+	typedef Histogram histogram_type;
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Remove all elements, without recording them. The histogram is kept.
+	 */
+	void truncate()
+	{
+		m_values.truncate();
+		m_stamps.truncate();
+	}
+
+	std::size_t size() const noexcept
+	{
+		return m_values.size();
+	}
+
+	bool empty() const noexcept
+	{
+		return m_values.empty();
+	}
+
+	bool full() const noexcept
+	{
+		return m_values.full();
+	}
+
+	std::size_t free() const noexcept
+	{
+		return m_values.free();
+	}
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return Nm;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	const value_type& front() const
+	{
+		return m_values.front();
+	}
+
+	const value_type& back() const
+	{
+		return m_values.back();
+	}
+
+	/**
+	 * Get how long the oldest element has been waiting, in nanoseconds. A growing age means
+	 * the consumer has stalled.
+	 */
+	std::uint64_t front_age() const
+	{
+		return Clock::to_ns(Clock::now() - m_stamps.front());
+	}
+
+	/**
+	 * Get the sojourn times of all popped elements, in nanoseconds.
+	 */
+	const histogram_type& sojourn() const noexcept
+	{
+		return m_sojourn;
+	}
+
+	histogram_type& sojourn() noexcept
+	{
+		return m_sojourn;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	void push(const value_type& v)
+	{
+		m_values.push(v);
+		m_stamps.push(Clock::now());
+	}
+
+	void push_list(const value_type* other_begin, const value_type* other_end)
+	{
+		m_values.push_list(other_begin, other_end);
+		const std::uint64_t now = Clock::now();
+		const auto stamp = [now](const value_type*, std::uint64_t* dst, std::size_t n) {
+			std::fill_n(dst, n, now);
+		};
+		m_stamps.push_list(other_begin, other_end, stamp);
+	}
+
+	value_type pop()
+	{
+		const value_type v = m_values.pop();
+		record(Clock::now(), 1);
+		return v;
+	}
+
+	/**
+	 * Remove multiple elements from the queue.
+	 *
+	 * @param n Number of items - Default: take all available items
+	 */
+	void pop_list(value_type* other_begin, std::size_t n = 0)
+	{
+		if(n == 0)
+			n = size();
+		m_values.pop_list(other_begin, n);
+		record(Clock::now(), n);
+	}
+
+	/**
+	 * Remove the `n` oldest elements, without copying them anywhere. They are recorded like
+	 * popped ones.
+	 */
+	void discard(std::size_t n)
+	{
+		m_values.discard(n);
+		record(Clock::now(), n);
+	}
+
+	/* @} */
+
+protected:
+	/**
+	 * Record and drop the stamps of the `n` oldest elements.
+	 */
+	void record(std::uint64_t now, std::size_t n)
+	{
+		for(std::size_t i = 0; i < n; i++)
+			m_sojourn.record(Clock::to_ns(now - m_stamps.pop()));
+	}
+
+	// Internal, never traced
+	fifo<value_type, Nm, no_trace> m_values;
+	fifo<std::uint64_t, Nm, no_trace> m_stamps; // Clock::now() at push, in the same order
+	histogram_type m_sojourn;
+};
+
+} // namespace cc
+
+#endif /* TIMED_FIFO_H */
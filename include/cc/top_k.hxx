@@ -0,0 +1,281 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(__AVX__)
+#	include <immintrin.h>
+#endif
+
+#include "buffer.hxx"
+
+namespace cc {
+
+namespace detail {
+
+/**
+ * Find the first element of `p[0..n)` that compares better than `t`.
+ *
+ * For `std::less` that is the first `x > t`, for `std::greater` the first `x < t`. Vectorized
+ * for float, double and 32-bit signed integers; other types and comparisons are scalar.
+ *
+ * @return Index of the element, or `n` if there is none
+ */
+template <typename Tp, typename Compare>
+inline std::size_t find_better(const Tp* p, std::size_t n, const Tp& t, const Compare& comp)
+{
+	std::size_t i = 0;
+
+	constexpr bool less = std::is_same<Compare, std::less<Tp>>::value
+			      || std::is_same<Compare, std::less<>>::value;
+	constexpr bool greater = std::is_same<Compare, std::greater<Tp>>::value
+				 || std::is_same<Compare, std::greater<>>::value;
+
+	if constexpr(less || greater) {
+#if defined(__AVX__)
+		if constexpr(std::is_same<Tp, float>::value) {
+			const __m256 tv = _mm256_set1_ps(t);
+			for(; i + 8 <= n; i += 8) {
+				const __m256 x = _mm256_loadu_ps(p + i);
+				const int m = _mm256_movemask_ps(
+					less ? _mm256_cmp_ps(x, tv, _CMP_GT_OQ)
+					     : _mm256_cmp_ps(x, tv, _CMP_LT_OQ));
+				if(m)
+					return i + static_cast<std::size_t>(__builtin_ctz(m));
+			}
+		} else if constexpr(std::is_same<Tp, double>::value) {
+			const __m256d tv = _mm256_set1_pd(t);
+			for(; i + 4 <= n; i += 4) {
+				const __m256d x = _mm256_loadu_pd(p + i);
+				const int m = _mm256_movemask_pd(
+					less ? _mm256_cmp_pd(x, tv, _CMP_GT_OQ)
+					     : _mm256_cmp_pd(x, tv, _CMP_LT_OQ));
+				if(m)
+					return i + static_cast<std::size_t>(__builtin_ctz(m));
+			}
+		}
+#endif
+#if defined(__SSE2__)
+		if constexpr(std::is_same<Tp, float>::value) {
+			const __m128 tv = _mm_set1_ps(t);
+			for(; i + 4 <= n; i += 4) {
+				const __m128 x = _mm_loadu_ps(p + i);
+				const __m128 y = less ? _mm_cmpgt_ps(x, tv) : _mm_cmplt_ps(x, tv);
+				const int m = _mm_movemask_ps(y);
+				if(m)
+					return i + static_cast<std::size_t>(__builtin_ctz(m));
+			}
+		} else if constexpr(std::is_integral<Tp>::value && std::is_signed<Tp>::value
+				    && sizeof(Tp) == 4) {
+			const __m128i tv = _mm_set1_epi32(t);
+			for(; i + 4 <= n; i += 4) {
+				const __m128i x =
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				const int m = _mm_movemask_ps(_mm_castsi128_ps(
+					less ? _mm_cmpgt_epi32(x, tv) : _mm_cmplt_epi32(x, tv)));
+				if(m)
+					return i + static_cast<std::size_t>(__builtin_ctz(m));
+			}
+		}
+#endif
+	}
+
+	for(; i < n; i++)
+		if(comp(t, p[i]))
+			return i;
+	return n;
+}
+
+} // namespace detail
+
+/**
+ * Keeps the `K` best elements offered so far, in a heap on fixed storage.
+ *
+ * Element `a` is better than `b` when `Compare(b, a)`, so the default `std::less` keeps the K
+ * largest values, and `std::greater` the K smallest. Once full, the worst kept element is the
+ * threshold that a candidate has to beat. Batches passed to offer() are scanned against that
+ * threshold with SIMD (for float, double and int32 with std::less or std::greater), so the
+ * rejected majority never touches the heap.
+ *
+ * @code
+ * cc::top_k<float, 100> worst;
+ * worst.offer(scores.data(), scores.data() + scores.size());
+ * for(float s : worst.sorted())
+ *         report(s);
+ * @endcode
+ *
+ * @tparam Tp Type of each element
+ * @tparam K Number of elements kept
+ * @tparam Compare Strict weak ordering, where "greater" is better
+ */
+template <typename Tp, std::size_t K, typename Compare = std::less<Tp>>
+class top_k {
+	static_assert(K > 0, "Need to keep at least one element");
+
+public:
+	typedef Tp value_type;
+	typedef typename buffer<Tp, K, no_trace>::const_iterator const_iterator;
+
+	explicit top_k(const Compare& comp = Compare())
+		: m_comp(comp)
+	{}
+
+	/**
+	 * @defgroup Capacity
+	 */
+	/* @{ */
+
+	/**
+	 * Forget all elements.
+	 */
+	void reset()
+	{
+		m_heap.reset();
+	}
+
+	std::size_t size() const noexcept
+	{
+		return m_heap.size();
+	}
+
+	bool empty() const noexcept
+	{
+		return m_heap.empty();
+	}
+
+	bool full() const noexcept
+	{
+		return m_heap.size() == K;
+	}
+
+	static constexpr std::size_t max_size() noexcept
+	{
+		return K;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Modifying element access
+	 */
+	/* @{ */
+
+	/**
+	 * Offer a single candidate.
+	 *
+	 * @return True if it was kept
+	 */
+	bool offer(const value_type& v)
+	{
+		if(!full()) {
+			m_heap.push_back(v);
+			std::push_heap(m_heap.begin(), m_heap.end(), heap_order{m_comp});
+			return true;
+		}
+		if(!m_comp(m_heap.front(), v))
+			return false;
+		replace(v);
+		return true;
+	}
+
+	/**
+	 * Offer a batch of candidates.
+	 *
+	 * @return Number of candidates that were kept (some may have been replaced again)
+	 */
+	std::size_t offer(const value_type* first, const value_type* last)
+	{
+		std::size_t kept = 0;
+		for(; first != last && !full(); first++)
+			kept += offer(*first);
+
+		while(first != last) {
+			const std::size_t n = static_cast<std::size_t>(last - first);
+			const std::size_t i = detail::find_better(first, n, m_heap.front(), m_comp);
+			if(i == n)
+				break;
+			replace(first[i]);
+			kept++;
+			first += i + 1;
+		}
+		return kept;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Element access
+	 */
+	/* @{ */
+
+	/**
+	 * Get the worst kept element, which a candidate has to beat once full.
+	 */
+	const value_type& threshold() const
+	{
+		if(empty())
+			std::__throw_out_of_range("top_k::threshold");
+		return m_heap.front();
+	}
+
+	/**
+	 * Get a copy of the kept elements, from best to worst.
+	 */
+	buffer<Tp, K, no_trace> sorted() const
+	{
+		buffer<Tp, K, no_trace> out = m_heap;
+		std::sort_heap(out.begin(), out.end(), heap_order{m_comp});
+		return out;
+	}
+
+	/* @} */
+
+	/**
+	 * @defgroup Iterator
+	 *
+	 * Iterates over the kept elements in heap order.
+	 */
+	/* @{ */
+
+	const_iterator begin() const noexcept
+	{
+		return m_heap.begin();
+	}
+
+	const_iterator end() const noexcept
+	{
+		return m_heap.end();
+	}
+
+	/* @} */
+
+protected:
+	/**
+	 * Heap order with the worst element on top.
+	 */
+	struct heap_order {
+		const Compare& comp;
+
+		bool operator()(const Tp& a, const Tp& b) const
+		{
+			return comp(b, a);
+		}
+	};
+
+	void replace(const value_type& v)
+	{
+		std::pop_heap(m_heap.begin(), m_heap.end(), heap_order{m_comp});
+		m_heap[K - 1] = v;
+		std::push_heap(m_heap.begin(), m_heap.end(), heap_order{m_comp});
+	}
+
+	buffer<Tp, K, no_trace> m_heap; // Internal, never traced
+	Compare m_comp;
+};
+
+} // namespace cc
+
+#endif /* TOP_K_H */
@@ -0,0 +1,135 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+
+/**
+ * USDT probes are available when <sys/sdt.h> is (systemtap-sdt-dev on Debian). Define
+ * `CC_TRACE_USDT` to 0 to leave them out regardless.
+ */
+#if !defined(CC_TRACE_USDT)
+#	if defined(__has_include)
+#		if __has_include(<sys/sdt.h>)
+#			define CC_TRACE_USDT 1
+#		endif
+#	endif
+#endif
+#if !defined(CC_TRACE_USDT)
+#	define CC_TRACE_USDT 0
+#endif
+#if CC_TRACE_USDT
+#	include <sys/sdt.h>
+#endif
+
+/**
+ * Trace policy of `cc::buffer` and `cc::fifo` when none is given, to trace all of them, for
+ * example `cc::usdt_trace`.
+ *
+ * This must be the same in every translation unit of a program: otherwise `cc::fifo<int, 4>`
+ * names different types in different files, which breaks the one-definition rule without any
+ * diagnostic. So set it project-wide, with the `CC_TRACE_POLICY` CMake cache variable, which
+ * defines it for everything that links `custom_containers`, rather than in a source file.
+ */
+#if !defined(CC_TRACE_POLICY)
+#	define CC_TRACE_POLICY cc::no_trace
+#endif
+
+namespace cc {
+
+/**
+ * @defgroup Trace policies
+ *
+ * A trace policy is the last template argument of `cc::buffer` and `cc::fifo`, and receives
+ * their events. It has a `static constexpr bool enabled`, and when that is true, these static
+ * functions:
+ *
+ *   - `push(const char* container, const void* self, std::size_t n, std::size_t size)`:
+ *     `n` elements were added, leaving `size` elements
+ *   - `pop(const char* container, const void* self, std::size_t n, std::size_t size)`:
+ *     `n` elements were removed, leaving `size` elements
+ *   - `full(const char* container, const void* self, std::size_t size)`:
+ *     a push left the container full
+ *   - `empty(const char* container, const void* self)`:
+ *     a pop left the container empty
+ *
+ * `container` is the class name ("buffer" or "fifo"), and `self` its address, to tell
+ * instances apart. Events are only emitted after successful operations. When `enabled` is
+ * false, the functions are never referenced, so no code is generated at all.
+ *
+ * @code
+ * struct count_full {
+ *         static constexpr bool enabled = true;
+ *         static void push(const char*, const void*, std::size_t, std::size_t) {}
+ *         static void pop(const char*, const void*, std::size_t, std::size_t) {}
+ *         static void full(const char*, const void*, std::size_t) { overflows++; }
+ *         static void empty(const char*, const void*) {}
+ * };
+ * cc::fifo<packet, 1024, count_full> queue;
+ * @endcode
+ */
+/* @{ */
+
+/**
+ * No tracing, the default.
+ */
+struct no_trace {
+	static constexpr bool enabled = false;
+};
+
+/**
+ * Emit USDT probes `cc:push`, `cc:pop`, `cc:full` and `cc:empty`, with the arguments of the
+ * policy functions. Unattached probes are a single nop each, so this can stay enabled in
+ * production builds, and be attached to when needed:
+ *
+ * @code
+ * bpftrace -e 'usdt:./server:cc:full { @[str(arg0), arg1] = count(); }'
+ * perf probe -x ./server sdt_cc:pop && perf record -e sdt_cc:pop -p $(pidof server)
+ * @endcode
+ *
+ * Without <sys/sdt.h>, this is the same as `no_trace`.
+ */
+struct usdt_trace {
+	static constexpr bool enabled = CC_TRACE_USDT != 0;
+
+	static void push(const char* container, const void* self, std::size_t n, std::size_t size)
+	{
+#if CC_TRACE_USDT
+		DTRACE_PROBE4(cc, push, container, self, n, size);
+#else
+		(void)container, (void)self, (void)n, (void)size;
+#endif
+	}
+
+	static void pop(const char* container, const void* self, std::size_t n, std::size_t size)
+	{
+#if CC_TRACE_USDT
+		DTRACE_PROBE4(cc, pop, container, self, n, size);
+#else
+		(void)container, (void)self, (void)n, (void)size;
+#endif
+	}
+
+	static void full(const char* container, const void* self, std::size_t size)
+	{
+#if CC_TRACE_USDT
+		DTRACE_PROBE3(cc, full, container, self, size);
+#else
+		(void)container, (void)self, (void)size;
+#endif
+	}
+
+	static void empty(const char* container, const void* self)
+	{
+#if CC_TRACE_USDT
+		DTRACE_PROBE2(cc, empty, container, self);
+#else
+		(void)container, (void)self;
+#endif
+	}
+};
+
+/* @} */
+
+} // namespace cc
+
+#endif /* TRACE_H */
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "cc/arrow.hxx"
+
+TEST(ArrowTest, Buffer)
+{
+	cc::buffer<float, 8> data;
+	data.push_back(1.0f);
+	data.push_back(2.0f);
+	data.push_back(3.0f);
+
+	ArrowArray array;
+	ArrowSchema schema;
+	cc::export_arrow(data, &array, &schema);
+
+	ASSERT_STREQ(schema.format, "f");
+	ASSERT_EQ(schema.n_children, 0);
+	ASSERT_EQ(array.length, 3);
+	ASSERT_EQ(array.null_count, 0);
+	ASSERT_EQ(array.offset, 0);
+	ASSERT_EQ(array.n_buffers, 2);
+	ASSERT_EQ(array.buffers[0], nullptr);
+	ASSERT_EQ(array.buffers[1], data.data()); // No copy
+
+	ASSERT_NE(array.release, nullptr);
+	array.release(&array);
+	ASSERT_EQ(array.release, nullptr);
+	schema.release(&schema);
+	ASSERT_EQ(schema.release, nullptr);
+}
+
+TEST(ArrowTest, Fifo)
+{
+	cc::fifo<std::int32_t, 4> data;
+	data.push(1);
+	data.push(2);
+
+	ArrowArray arrays[2];
+	ArrowSchema schema;
+	ASSERT_EQ(cc::export_arrow(data, arrays, &schema), 1);
+	ASSERT_STREQ(schema.format, "i");
+	ASSERT_EQ(arrays[0].length, 2);
+	arrays[0].release(&arrays[0]);
+	schema.release(&schema);
+
+	data.discard(2);
+	data.push(3);
+	data.push(4);
+	data.push(5);
+
+	ASSERT_EQ(cc::export_arrow(data, arrays, &schema), 2);
+	ASSERT_EQ(arrays[0].length, 2);
+	ASSERT_EQ(static_cast<const std::int32_t*>(arrays[0].buffers[1])[0], 3);
+	ASSERT_EQ(arrays[1].length, 1);
+	ASSERT_EQ(static_cast<const std::int32_t*>(arrays[1].buffers[1])[0], 5);
+	arrays[0].release(&arrays[0]);
+	arrays[1].release(&arrays[1]);
+	schema.release(&schema);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "cc/bitstream.hxx"
+
+TEST(BitstreamTest, Layout)
+{
+	cc::buffer<std::uint8_t, 16> data;
+	cc::bit_writer<cc::buffer<std::uint8_t, 16>> w(data);
+
+	w.write(0x5, 3);
+	w.write(0x1F, 5);
+	w.write(0xABC, 12);
+	ASSERT_EQ(data.size(), 0); // Still in the accumulator
+	ASSERT_EQ(w.pending(), 20);
+
+	w.flush();
+	ASSERT_EQ(data.size(), 3);
+	ASSERT_EQ(data[0], 0xFD);
+	ASSERT_EQ(data[1], 0xBC);
+	ASSERT_EQ(data[2], 0x0A);
+
+	cc::bit_reader<cc::buffer<std::uint8_t, 16>> r(data);
+	ASSERT_EQ(r.available(), 24);
+	ASSERT_EQ(r.read(3), 0x5);
+	ASSERT_EQ(r.read(5), 0x1F);
+	ASSERT_EQ(r.read(12), 0xABC);
+	r.align();
+	ASSERT_EQ(r.available(), 0);
+	ASSERT_THROW({ r.read(1); }, std::out_of_range);
+}
+
+TEST(BitstreamTest, RoundTrip)
+{
+	std::mt19937_64 rng(1);
+	std::vector<std::pair<std::uint64_t, unsigned>> fields;
+	for(int i = 0; i < 500; i++) {
+		const unsigned bits = static_cast<unsigned>(rng() % 65);
+		fields.emplace_back(cc::detail::low_bits(rng(), bits), bits);
+	}
+
+	cc::buffer<std::uint8_t, 4096> data;
+	cc::bit_writer<cc::buffer<std::uint8_t, 4096>> w(data);
+	for(auto const& f : fields)
+		w.write(f.first, f.second);
+	w.flush();
+
+	cc::bit_reader<cc::buffer<std::uint8_t, 4096>> r(data);
+	for(auto const& f : fields)
+		ASSERT_EQ(r.read(f.second), f.first);
+}
+
+TEST(BitstreamTest, Fifo)
+{
+	cc::fifo<std::uint8_t, 32> data;
+	cc::bit_writer<cc::fifo<std::uint8_t, 32>> w(data);
+	cc::bit_reader<cc::fifo<std::uint8_t, 32>> r(data);
+
+	// Wrap around the fifo a few times
+	for(std::uint64_t i = 0; i < 200; i++) {
+		w.write(i, 17);
+		w.write(i & 7, 3);
+		w.flush();
+		ASSERT_EQ(r.read(17), i);
+		ASSERT_EQ(r.read(3), i & 7);
+		r.align();
+	}
+	ASSERT_TRUE(data.empty());
+}
+
+TEST(BitstreamTest, List)
+{
+	std::vector<std::uint16_t> values;
+	for(unsigned i = 0; i < 103; i++)
+		values.push_back(static_cast<std::uint16_t>((i * 37) & 0xFFF));
+
+	cc::buffer<std::uint8_t, 256> data;
+	cc::bit_writer<cc::buffer<std::uint8_t, 256>> w(data);
+	w.write(1, 1); // Unaligned start
+	w.write_list(values.data(), values.size(), 12);
+	w.flush();
+	ASSERT_EQ(data.size(), (1 + 103 * 12 + 7) / 8);
+
+	cc::bit_reader<cc::buffer<std::uint8_t, 256>> r(data);
+	ASSERT_EQ(r.read(1), 1);
+	std::vector<std::uint16_t> check(values.size());
+	r.read_list(check.data(), check.size(), 12);
+	ASSERT_EQ(check, values);
+}
+
+TEST(BitstreamTest, Full)
+{
+	cc::buffer<std::uint8_t, 4> data;
+	cc::bit_writer<cc::buffer<std::uint8_t, 4>> w(data);
+	w.write(0, 32);
+	w.flush();
+	ASSERT_EQ(data.size(), 4);
+	ASSERT_THROW({
+		w.write(0, 8);
+		w.flush();
+	}, std::out_of_range);
+}
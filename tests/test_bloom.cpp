@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cc/bloom.hxx"
+#include "cc/buffer.hxx"
+
+template <std::size_t K>
+static void check_bloom()
+{
+	cc::bloom<1 << 16, K> filter;
+	for(std::uint32_t i = 0; i < 4000; i++)
+		filter.insert(i * 7);
+
+	for(std::uint32_t i = 0; i < 4000; i++)
+		ASSERT_TRUE(filter.contains(i * 7));
+
+	// 4000 keys in 64 Kib: about 6% of false positives with one bit per key, under 1% with more
+	std::size_t false_positives = 0;
+	for(std::uint32_t i = 0; i < 10000; i++)
+		false_positives += filter.contains(i * 7 + 1000003);
+	ASSERT_LT(false_positives, K == 1 ? 800 : 100);
+
+	filter.reset();
+	ASSERT_FALSE(filter.contains(7u));
+}
+
+TEST(BloomTest, Contains)
+{
+	check_bloom<1>();
+	check_bloom<5>();
+	check_bloom<8>();
+	check_bloom<12>();
+	check_bloom<16>();
+}
+
+TEST(BloomTest, Batch)
+{
+	cc::bloom<4096, 6> filter;
+	cc::buffer<std::uint64_t, 200> keys;
+	for(std::uint64_t i = 0; i < 200; i++) {
+		keys.push_back(i);
+		if(i % 3 == 0)
+			filter.insert(i);
+	}
+
+	std::uint64_t mask[4];
+	const std::size_t found = filter.contains(keys.begin(), keys.end(), mask);
+	for(std::size_t i = 0; i < 200; i++) {
+		const bool hit = mask[i / 64] >> (i % 64) & 1;
+		ASSERT_EQ(hit, filter.contains(keys[i]));
+		if(i % 3 == 0) {
+			ASSERT_TRUE(hit);
+		}
+	}
+
+	keys.compact(mask);
+	ASSERT_EQ(keys.size(), found);
+	ASSERT_GE(found, 67);
+	ASSERT_EQ(keys[0], 0);
+}
+
+TEST(BloomTest, Merge)
+{
+	cc::bloom<1024, 4> a, b;
+	std::vector<std::string> words = {"alpha", "beta", "gamma", "delta"};
+	a.insert(words.data(), words.data() + 2);
+	b.insert(words.data() + 2, words.data() + 4);
+	ASSERT_FALSE(a.contains(std::string("gamma")) && a.contains(std::string("delta")));
+
+	a.merge(b);
+	for(const auto& w : words)
+		ASSERT_TRUE(a.contains(w));
+	ASSERT_EQ(a.blocks(), 2);
+	ASSERT_EQ(a.hashes(), 4);
+}
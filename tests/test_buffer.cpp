@@ -39,3 +39,51 @@ TEST(BufferTest, Basic)
         ASSERT_EQ(data.array()[1], 2.0f);
         ASSERT_EQ(data.array()[2], 3.0f);
 }
+
+TEST(BufferTest, Compact)
+{
+        cc::buffer<std::uint32_t, 300> data;
+        for (std::uint32_t i = 0; i < 277; i++)
+                data.push_back(i * 7);
+
+        data.compact_if([](std::uint32_t v) { return v % 3 != 0; });
+        ASSERT_EQ(data.size(), 184);
+
+        std::uint32_t expected = 0;
+        for (auto v : data)
+        {
+                do
+                        expected += 7;
+                while (expected % 3 == 0);
+                ASSERT_EQ(v, expected);
+        }
+
+        // Keep every other element, the last word only partially used
+        std::uint64_t mask[3] = {0x5555555555555555u, 0x5555555555555555u, ~0ull};
+        data.compact(mask);
+        ASSERT_EQ(data.size(), 120);
+        ASSERT_EQ(data[0], 7);
+        ASSERT_EQ(data[1], 28);
+        ASSERT_EQ(data[119], expected);
+}
+
+TEST(BufferTest, CompactTypes)
+{
+        cc::buffer<double, 40> d;
+        cc::buffer<std::uint16_t, 40> s;
+        for (int i = 0; i < 37; i++)
+        {
+                d.push_back(i);
+                s.push_back(static_cast<std::uint16_t>(i));
+        }
+        d.compact_if([](double v) { return v >= 10.0; });
+        s.compact_if([](std::uint16_t v) { return v & 1; });
+        ASSERT_EQ(d.size(), 27);
+        ASSERT_EQ(d[0], 10.0);
+        ASSERT_EQ(d[26], 36.0);
+        ASSERT_EQ(s.size(), 18);
+        ASSERT_EQ(s[17], 35);
+
+        d.compact_if([](double) { return false; });
+        ASSERT_TRUE(d.empty());
+}
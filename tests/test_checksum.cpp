@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "cc/checksum.hxx"
+
+TEST(ChecksumTest, Reference)
+{
+	// Check value of the CRC-32C catalogue entry
+	const char* s = "123456789";
+	cc::crc32c crc;
+	crc.update(s, std::strlen(s));
+	ASSERT_EQ(crc.value(), 0xE3069283u);
+
+	crc.reset();
+	ASSERT_EQ(crc.value(), 0u);
+}
+
+TEST(ChecksumTest, Incremental)
+{
+	cc::buffer<std::uint8_t, 64> data;
+	for(int i = 0; i < 61; i++)
+		data.push_back(static_cast<std::uint8_t>(i * 7));
+
+	cc::crc32c crc;
+	for(auto v : data)
+		crc.update(&v, 1);
+
+	ASSERT_EQ(crc.value(), cc::checksum(data));
+}
+
+TEST(ChecksumTest, Fifo)
+{
+	cc::fifo<std::uint32_t, 10> data;
+	cc::buffer<std::uint32_t, 10> flat;
+
+	for(std::uint32_t i = 0; i < 8; i++)
+		data.push(i);
+	data.discard(6);
+	for(std::uint32_t i = 8; i < 14; i++)
+		data.push(i);
+	ASSERT_GT(data.second_segment_size(), 0);
+
+	for(auto v : data)
+		flat.push_back(v);
+
+	ASSERT_EQ(flat.size(), 8);
+	ASSERT_EQ(cc::checksum(data), cc::checksum(flat));
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cc/compressed_float_buffer.hxx"
+
+TEST(CompressedFloatBufferTest, Float)
+{
+	cc::compressed_float_buffer<4096> data;
+	ASSERT_TRUE(data.empty());
+
+	cc::buffer<float, 1000> values;
+	for(int i = 0; i < 1000; i++)
+		values.push_back(20.0f + std::floor(std::sin(i * 0.01f) * 8.0f) * 0.25f);
+	for(auto v : values)
+		data.push_back(v);
+
+	ASSERT_EQ(data.size(), 1000);
+	ASSERT_LT(data.bytes(), 4000 / 5); // Slowly changing, so at least 5x smaller
+
+	cc::buffer<float, 1000> check;
+	data.decode(check);
+	ASSERT_EQ(check.size(), values.size());
+	for(std::size_t i = 0; i < values.size(); i++)
+		ASSERT_EQ(check[i], values[i]);
+}
+
+TEST(CompressedFloatBufferTest, Double)
+{
+	cc::compressed_float_buffer<1024, double> data;
+
+	std::vector<double> values{
+		1.0,
+		1.0,
+		-1.0,
+		0.0,
+		std::numeric_limits<double>::max(),
+		std::numeric_limits<double>::denorm_min(),
+		std::numeric_limits<double>::infinity(),
+		3.14159,
+		3.14159,
+		3.25,
+		-0.0};
+	for(auto v : values)
+		data.push_back(v);
+
+	std::vector<double> check;
+	data.for_each([&](double v) { check.push_back(v); });
+	ASSERT_EQ(check.size(), values.size());
+	for(std::size_t i = 0; i < values.size(); i++) {
+		ASSERT_EQ(check[i], values[i]);
+		ASSERT_EQ(std::signbit(check[i]), std::signbit(values[i]));
+	}
+}
+
+TEST(CompressedFloatBufferTest, Full)
+{
+	cc::compressed_float_buffer<8> data;
+	data.push_back(1.0f); // 32 bits
+	data.push_back(1.0f); // 1 bit
+	data.push_back(-1.0f); // 2 + 5 + 5 + 1 bits
+	ASSERT_THROW({ data.push_back(12345.678f); }, std::out_of_range);
+	ASSERT_EQ(data.size(), 3);
+
+	cc::buffer<float, 2> small;
+	ASSERT_THROW({ data.decode(small); }, std::out_of_range);
+
+	data.reset();
+	ASSERT_TRUE(data.empty());
+	data.push_back(2.0f);
+	cc::buffer<float, 2> check;
+	data.decode(check);
+	ASSERT_EQ(check.size(), 1);
+	ASSERT_EQ(check[0], 2.0f);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cc/buffer.hxx"
+#include "cc/convert.hxx"
+#include "cc/fifo.hxx"
+
+TEST(ConvertTest, S16ToFloat)
+{
+	std::vector<std::int16_t> pcm;
+	for(int i = 0; i < 37; i++)
+		pcm.push_back(static_cast<std::int16_t>(i * 1771 - 32768));
+
+	cc::fifo<float, 50> data;
+	data.push_list(pcm.data(), pcm.data() + 30, cc::s16_to_float());
+	data.discard(30);
+	data.push_list(pcm.data(), pcm.data() + pcm.size(), cc::s16_to_float(1.0f / 32768.0f));
+	ASSERT_EQ(data.size(), 37);
+	ASSERT_EQ(data.second_segment_size(), 17); // Converted in two segments
+
+	std::size_t i = 0;
+	for(auto v : data)
+		ASSERT_EQ(v, static_cast<float>(pcm[i++]) / 32768.0f);
+
+	ASSERT_THROW(
+		{ data.push_list(pcm.data(), pcm.data() + 14, cc::s16_to_float()); },
+		std::out_of_range);
+}
+
+TEST(ConvertTest, FloatToS16)
+{
+	std::vector<float> src{
+		0.0f,
+		0.5f,
+		1.5f,
+		2.5f,
+		-0.5f,
+		-1.5f,
+		100.4f,
+		-100.6f,
+		32767.4f,
+		32768.0f,
+		1e10f,
+		-32768.0f,
+		-1e10f,
+		std::numeric_limits<float>::infinity(),
+		-std::numeric_limits<float>::infinity(),
+		std::nanf("")};
+	std::vector<std::int16_t> expected{
+		0, 0, 2, 2, 0, -2, 100, -101, 32767, 32767, 32767,
+		-32768, -32768, 32767, -32768, -32768};
+
+	// Repeat, to hit all vector widths and the scalar tail
+	std::vector<float> in;
+	std::vector<std::int16_t> out_expected;
+	for(int r = 0; r < 5; r++) {
+		in.insert(in.end(), src.begin(), src.end());
+		out_expected.insert(out_expected.end(), expected.begin(), expected.end());
+	}
+	in.push_back(-3.0f);
+	out_expected.push_back(-3);
+
+	cc::fifo<float, 100> data;
+	data.push_list(in.data(), in.data() + in.size());
+
+	std::vector<std::int16_t> out(in.size());
+	data.pop_list(out.data(), 0, cc::float_to_s16());
+	ASSERT_TRUE(data.empty());
+	ASSERT_EQ(out, out_expected);
+}
+
+TEST(ConvertTest, Scale)
+{
+	const float src[3] = {1.0f, -1.0f, 0.25f};
+	std::int16_t out[3];
+	cc::float_to_s16(32767.0f)(src, out, 3);
+	ASSERT_EQ(out[0], 32767);
+	ASSERT_EQ(out[1], -32767);
+	ASSERT_EQ(out[2], 8192);
+}
+
+TEST(ConvertTest, BufferAppend)
+{
+	const std::int16_t src[4] = {1, 2, 3, 4};
+	cc::buffer<double, 6> data;
+	data.push_back(0.0);
+
+	data.append(src, src + 4, cc::cast_convert());
+	ASSERT_EQ(data.size(), 5);
+	ASSERT_EQ(data[4], 4.0);
+	ASSERT_THROW({ data.append(src, src + 2, cc::cast_convert()); }, std::out_of_range);
+
+	const double more[1] = {5.0};
+	data.append(more, more + 1);
+	ASSERT_EQ(data.size(), 6);
+	ASSERT_EQ(data[5], 5.0);
+	ASSERT_THROW({ data.append(more, more + 1); }, std::out_of_range);
+}
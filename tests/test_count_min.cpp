@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+
+#include "cc/count_min.hxx"
+
+template <std::size_t D>
+static void check_count_min()
+{
+	cc::count_min<1024, D> sketch;
+	std::map<std::uint32_t, std::uint32_t> exact;
+
+	std::mt19937 rng(D);
+	std::geometric_distribution<std::uint32_t> dist(0.01);
+	for(int i = 0; i < 20000; i++) {
+		const std::uint32_t key = dist(rng);
+		sketch.add(key);
+		exact[key]++;
+	}
+	ASSERT_EQ(sketch.total(), 20000);
+
+	std::size_t exact_estimates = 0;
+	for(const auto& kv : exact) {
+		const auto e = sketch.estimate(kv.first);
+		ASSERT_GE(e, kv.second);
+		// Way above e / W * total for multiple rows; a single row has no useful bound
+		ASSERT_LE(e, kv.second + (D > 1 ? 200 : 20000));
+		exact_estimates += e == kv.second;
+	}
+	if(D > 1) {
+		ASSERT_GT(exact_estimates, exact.size() / 2);
+		ASSERT_LE(sketch.estimate(123456789u), 200);
+	}
+}
+
+TEST(CountMinTest, Estimate)
+{
+	check_count_min<1>();
+	check_count_min<4>();
+	check_count_min<8>();
+	check_count_min<11>();
+}
+
+TEST(CountMinTest, Keys)
+{
+	cc::count_min<256, 4, std::uint64_t> sketch;
+	sketch.add(std::string("alpha"), 5);
+	sketch.add(std::string("beta"));
+	ASSERT_EQ(sketch.estimate(std::string("alpha")), 5);
+	ASSERT_EQ(sketch.estimate(std::string("beta")), 1);
+
+	cc::count_min<256, 4, std::uint64_t> other;
+	other.add(std::string("alpha"), 2);
+	sketch.merge(other);
+	ASSERT_EQ(sketch.estimate(std::string("alpha")), 7);
+	sketch.subtract(other);
+	ASSERT_EQ(sketch.estimate(std::string("alpha")), 5);
+	ASSERT_EQ(sketch.total(), 6);
+
+	sketch.reset();
+	ASSERT_EQ(sketch.estimate(std::string("alpha")), 0);
+}
+
+TEST(CountMinTest, Windowed)
+{
+	cc::windowed_count_min<512, 4, 3> window;
+	ASSERT_EQ(window.epochs(), 1);
+
+	window.add(1, 10);
+	window.advance();
+	window.add(2, 20);
+	window.advance();
+	window.add(1, 1);
+	ASSERT_EQ(window.epochs(), 3);
+	ASSERT_EQ(window.estimate(1), 11);
+	ASSERT_EQ(window.total(), 31);
+
+	window.advance(); // Drops the first epoch
+	ASSERT_EQ(window.epochs(), 3);
+	ASSERT_EQ(window.estimate(1), 1);
+	ASSERT_EQ(window.estimate(2), 20);
+
+	window.advance();
+	window.advance();
+	ASSERT_EQ(window.total(), 0);
+	ASSERT_EQ(window.estimate(1), 0);
+
+	window.add(3);
+	window.reset();
+	ASSERT_EQ(window.epochs(), 1);
+	ASSERT_EQ(window.estimate(3), 0);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include "cc/delta_fifo.hxx"
+
+TEST(DeltaFifoTest, Timestamps)
+{
+	cc::delta_fifo<std::int64_t, 64, 8> data;
+	ASSERT_TRUE(data.empty());
+
+	std::vector<std::int64_t> values;
+	std::int64_t t = 1700000000000;
+	for(int i = 0; i < 200; i++) {
+		t += 1000 + (i % 3) - 1; // Jitter around a steady rate
+		values.push_back(t);
+		data.push(t);
+	}
+
+	ASSERT_EQ(data.size(), 200);
+	ASSERT_EQ(data.back(), t);
+	ASSERT_LE(data.bytes(), 200); // At most a byte per value
+
+	std::vector<std::int64_t> check(data.size());
+	ASSERT_EQ(data.copy(check.data()), check.data() + check.size());
+	ASSERT_EQ(check, values);
+}
+
+TEST(DeltaFifoTest, Extremes)
+{
+	cc::delta_fifo<std::int64_t, 16, 32> data;
+	std::vector<std::int64_t> values{
+		0,
+		std::numeric_limits<std::int64_t>::max(),
+		std::numeric_limits<std::int64_t>::min(),
+		-1,
+		1,
+		std::numeric_limits<std::int64_t>::min(),
+		42};
+
+	for(auto v : values)
+		data.push(v);
+
+	std::vector<std::int64_t> check;
+	data.for_each([&](std::int64_t v) { check.push_back(v); });
+	ASSERT_EQ(check, values);
+}
+
+TEST(DeltaFifoTest, Evict)
+{
+	cc::delta_fifo<std::uint32_t, 16, 2> data;
+
+	// First value is kept as is, then 16 single-byte codes fit a block
+	std::uint32_t v = 0;
+	while(data.blocks() < 2 || data.size() < 34)
+		data.push(v++);
+	ASSERT_EQ(data.size(), 34);
+	ASSERT_TRUE(data.full());
+	ASSERT_THROW({ data.push(v); }, std::out_of_range);
+
+	ASSERT_EQ(data.evict(), 17);
+	ASSERT_EQ(data.size(), 17);
+	data.push(v++);
+
+	std::uint32_t check = 17;
+	data.for_each([&](std::uint32_t x) { ASSERT_EQ(x, check++); });
+	ASSERT_EQ(check, v);
+
+	data.truncate();
+	ASSERT_TRUE(data.empty());
+	ASSERT_THROW({ data.evict(); }, std::out_of_range);
+}
@@ -129,3 +129,54 @@ TEST(FifoTest, ForLoop)
 		check += 1.0f;
 	}
 }
+
+TEST(FifoTest, Segments)
+{
+	cc::fifo<float, 5> data;
+	data.push(1.0f);
+	data.push(2.0f);
+	data.push(3.0f);
+	data.push(4.0f);
+	data.discard(3);
+	ASSERT_EQ(data.size(), 1);
+
+	data.push(5.0f);
+	data.push(6.0f);
+	data.push(7.0f);
+
+	ASSERT_EQ(data.first_segment_size(), 2);
+	ASSERT_EQ(data.first_segment()[0], 4.0f);
+	ASSERT_EQ(data.first_segment()[1], 5.0f);
+	ASSERT_EQ(data.second_segment_size(), 2);
+	ASSERT_EQ(data.second_segment()[0], 6.0f);
+	ASSERT_EQ(data.second_segment()[1], 7.0f);
+
+	float check = 4.0f;
+	for(const auto& v : data) {
+		ASSERT_EQ(check, v);
+		check += 1.0f;
+	}
+	ASSERT_EQ(check, 8.0f);
+
+	ASSERT_THROW({ data.discard(5); }, std::out_of_range);
+}
+
+TEST(FifoTest, FrontBack)
+{
+	cc::fifo<float, 3> data;
+	ASSERT_THROW({ data.front(); }, std::out_of_range);
+	ASSERT_THROW({ data.back(); }, std::out_of_range);
+
+	data.push(1.0f);
+	data.push(2.0f);
+	data.push(3.0f);
+	data.pop();
+	data.push(4.0f);
+
+	ASSERT_EQ(data.front(), 2.0f);
+	ASSERT_EQ(data.back(), 4.0f);
+	data.back() = 5.0f;
+	data.pop();
+	data.pop();
+	ASSERT_EQ(data.front(), 5.0f);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "cc/half.hxx"
+
+TEST(HalfTest, Float16)
+{
+	ASSERT_EQ(cc::float16(1.0f).bits, 0x3C00);
+	ASSERT_EQ(cc::float16(-2.0f).bits, 0xC000);
+	ASSERT_EQ(cc::float16(65504.0f).bits, 0x7BFF);
+	ASSERT_EQ(cc::float16(65520.0f).bits, 0x7C00); // Rounds to Inf
+	ASSERT_EQ(cc::float16(std::ldexp(1.0f, -24)).bits, 0x0001);
+	ASSERT_EQ(cc::float16(std::ldexp(1.0f, -26)).bits, 0x0000);
+	ASSERT_EQ(cc::float16(1.0f / 3.0f).bits, 0x3555);
+	ASSERT_EQ(cc::float16(std::numeric_limits<float>::infinity()).bits, 0x7C00);
+	ASSERT_TRUE(std::isnan(float(cc::float16(std::nanf("")))));
+
+	ASSERT_EQ(float(cc::float16(0.5f)), 0.5f);
+	ASSERT_EQ(float(cc::float16(std::ldexp(1.0f, -20))), std::ldexp(1.0f, -20));
+}
+
+TEST(HalfTest, Bfloat16)
+{
+	ASSERT_EQ(cc::bfloat16(1.0f).bits, 0x3F80);
+	// Tie to even
+	ASSERT_EQ(cc::bfloat16::from_float(cc::detail::bits_float(0x3F808000u)), 0x3F80);
+	ASSERT_EQ(cc::bfloat16::from_float(cc::detail::bits_float(0x3F818000u)), 0x3F82);
+	ASSERT_EQ(cc::bfloat16::from_float(cc::detail::bits_float(0x3F808001u)), 0x3F81);
+	ASSERT_TRUE(std::isnan(float(cc::bfloat16(std::nanf("")))));
+	ASSERT_EQ(float(cc::bfloat16(-3.0f)), -3.0f);
+}
+
+TEST(HalfTest, Bulk)
+{
+	std::mt19937 rng(3);
+	std::vector<float> src(1003);
+	for(auto& v : src) {
+		do
+			v = cc::detail::bits_float(static_cast<std::uint32_t>(rng()) & 0xC7FFFFFFu);
+		while(std::isnan(v));
+	}
+	src[10] = std::nanf("");
+
+	std::vector<cc::float16> h(src.size());
+	std::vector<cc::bfloat16> b(src.size());
+	cc::convert(src.data(), h.data(), src.size());
+	cc::convert(src.data(), b.data(), src.size());
+
+	std::vector<float> hf(src.size());
+	std::vector<float> bf(src.size());
+	cc::convert(h.data(), hf.data(), h.size());
+	cc::convert(b.data(), bf.data(), b.size());
+
+	for(std::size_t i = 0; i < src.size(); i++) {
+		if(i == 10) {
+			ASSERT_TRUE(std::isnan(hf[i]));
+			ASSERT_TRUE(std::isnan(bf[i]));
+			continue;
+		}
+		ASSERT_EQ(h[i].bits, cc::float16(src[i]).bits);
+		ASSERT_EQ(b[i].bits, cc::bfloat16(src[i]).bits);
+		ASSERT_EQ(hf[i], float(cc::float16(src[i])));
+		ASSERT_EQ(bf[i], float(cc::bfloat16(src[i])));
+	}
+}
+
+TEST(HalfTest, Buffer)
+{
+	cc::buffer<cc::float16, 64> data;
+	std::vector<float> src;
+	for(int i = 0; i < 40; i++)
+		src.push_back(static_cast<float>(i) * 0.25f);
+
+	cc::append(data, src.data(), src.data() + src.size());
+	ASSERT_EQ(data.size(), 40);
+	ASSERT_EQ(float(data[3]), 0.75f);
+	ASSERT_THROW({ cc::append(data, src.data(), src.data() + src.size()); }, std::out_of_range);
+
+	std::vector<float> check(40);
+	cc::copy(data, check.data());
+	ASSERT_EQ(check, src);
+
+	data.push_back(1.5f);
+	ASSERT_EQ(float(data.pop_back()), 1.5f);
+}
+
+TEST(HalfTest, Fifo)
+{
+	cc::fifo<cc::float16, 600> data;
+	std::vector<float> src;
+	for(int i = 0; i < 500; i++)
+		src.push_back(static_cast<float>(i));
+
+	cc::push_list(data, src.data(), src.data() + src.size());
+	data.discard(400);
+	cc::push_list(data, src.data(), src.data() + src.size()); // Wraps
+	ASSERT_EQ(data.size(), 600);
+	ASSERT_THROW({ cc::push_list(data, src.data(), src.data() + 1); }, std::out_of_range);
+
+	std::vector<float> check(600);
+	cc::pop_list(data, check.data());
+	ASSERT_TRUE(data.empty());
+	for(int i = 0; i < 100; i++)
+		ASSERT_EQ(check[i], static_cast<float>(i + 400));
+	for(int i = 0; i < 500; i++)
+		ASSERT_EQ(check[i + 100], static_cast<float>(i));
+}
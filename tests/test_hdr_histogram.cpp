@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "cc/hdr_histogram.hxx"
+
+template <unsigned Digits>
+static void check_percentiles()
+{
+	cc::hdr_histogram<3600000000000, Digits> h; // An hour in ns
+	std::vector<std::uint64_t> values;
+	std::mt19937_64 rng(Digits);
+	std::lognormal_distribution<double> dist(10.0, 2.0);
+	for(int i = 0; i < 100000; i++) {
+		values.push_back(static_cast<std::uint64_t>(dist(rng)));
+		h.record(values.back());
+	}
+	std::sort(values.begin(), values.end());
+
+	const double resolution = std::pow(10.0, -static_cast<double>(Digits));
+	for(double p : {0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0}) {
+		const std::size_t rank = std::max<std::size_t>(
+			1, static_cast<std::size_t>(p / 100 * values.size() + 0.5));
+		const double exact = static_cast<double>(values[rank - 1]);
+		const double v = static_cast<double>(h.value_at_percentile(p));
+		ASSERT_GE(v, exact) << p;
+		ASSERT_LE(v, exact * (1 + resolution) + 1) << p;
+	}
+	ASSERT_EQ(h.min(), values.front());
+	ASSERT_EQ(h.max(), values.back());
+	ASSERT_EQ(h.count(), values.size());
+}
+
+TEST(HdrHistogramTest, Percentiles)
+{
+	check_percentiles<1>();
+	check_percentiles<2>();
+	check_percentiles<3>();
+	check_percentiles<4>();
+}
+
+TEST(HdrHistogramTest, Small)
+{
+	cc::hdr_histogram<1000, 3> h;
+	ASSERT_THROW({ h.value_at_percentile(50); }, std::out_of_range);
+	ASSERT_THROW({ h.mean(); }, std::out_of_range);
+
+	// Exact below 2048 sub-buckets
+	for(std::uint64_t v = 0; v <= 1000; v++)
+		h.record(v);
+	ASSERT_EQ(h.value_at_percentile(50), 500);
+	ASSERT_EQ(h.count_at(77), 1);
+	ASSERT_DOUBLE_EQ(h.mean(), 500.0);
+
+	// Out of range percentiles are clamped
+	ASSERT_EQ(h.value_at_percentile(-50), 0);
+	ASSERT_EQ(h.value_at_percentile(NAN), 0);
+	ASSERT_EQ(h.value_at_percentile(150), 1000);
+
+	h.record(5000, 3); // Clamped
+	ASSERT_EQ(h.max(), 1000);
+	ASSERT_EQ(h.count_at(1000), 4);
+	ASSERT_EQ(h.count(), 1004);
+}
+
+TEST(HdrHistogramTest, MergeReset)
+{
+	cc::hdr_histogram<1000000, 2> a, b, total;
+	for(std::uint64_t v = 1; v <= 1000; v++) {
+		(v % 2 ? a : b).record(v * 100);
+		total.record(v * 100);
+	}
+	a.merge(b);
+	ASSERT_EQ(a.count(), total.count());
+	for(double p : {10.0, 50.0, 99.0})
+		ASSERT_EQ(a.value_at_percentile(p), total.value_at_percentile(p));
+	ASSERT_EQ(a.min(), 100);
+
+	a.reset();
+	ASSERT_EQ(a.count(), 0);
+	ASSERT_EQ(a.count_at(50000), 0);
+	a.record(7);
+	ASSERT_EQ(a.value_at_percentile(100), 7);
+	ASSERT_EQ(a.min(), 7);
+
+	b.reset();
+	a.merge(b); // Empty
+	ASSERT_EQ(a.count(), 1);
+}
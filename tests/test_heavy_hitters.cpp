@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+
+#include "cc/heavy_hitters.hxx"
+
+TEST(HeavyHittersTest, SpaceSaving)
+{
+	cc::heavy_hitters<std::uint32_t, 32> hh;
+	std::map<std::uint32_t, std::uint64_t> exact;
+
+	// A few heavy keys in a lot of noise
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<std::uint32_t> noise(100, 100000);
+	for(int i = 0; i < 50000; i++) {
+		const auto key = i % 5 == 0 ? static_cast<std::uint32_t>(i % 3) : noise(rng);
+		hh.add(key);
+		exact[key]++;
+	}
+	ASSERT_EQ(hh.total(), 50000);
+	ASSERT_EQ(hh.size(), 32);
+
+	const auto top = hh.sorted();
+	ASSERT_EQ(top.size(), 32);
+	for(std::size_t i = 0; i < 3; i++) {
+		ASSERT_LT(top[i].key, 3);
+		ASSERT_GE(top[i].count, exact[top[i].key]);
+		ASSERT_LE(top[i].count - top[i].error, exact[top[i].key]);
+	}
+	for(std::size_t i = 1; i < top.size(); i++)
+		ASSERT_GE(top[i - 1].count, top[i].count);
+
+	ASSERT_EQ(hh.count(1), top[0].key == 1 ? top[0].count : hh.count(1));
+	ASSERT_GE(hh.count(0), exact[0]);
+}
+
+TEST(HeavyHittersTest, Replace)
+{
+	cc::heavy_hitters<char, 2> hh;
+	hh.add('a', 5);
+	hh.add('b', 2);
+	hh.add('c'); // Replaces 'b'
+	ASSERT_EQ(hh.size(), 2);
+	ASSERT_EQ(hh.count('b'), 0);
+	ASSERT_EQ(hh.count('c'), 3);
+
+	const auto top = hh.sorted();
+	ASSERT_EQ(top[1].key, 'c');
+	ASSERT_EQ(top[1].error, 2);
+
+	hh.reset();
+	ASSERT_EQ(hh.size(), 0);
+	ASSERT_EQ(hh.count('a'), 0);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "cc/multichannel_fifo.hxx"
+
+/**
+ * Sample value of frame `f`, channel `c`, unique within the tests.
+ */
+template <typename Tp>
+static Tp sample(std::size_t f, std::size_t c)
+{
+	return static_cast<Tp>(f * 64 + c);
+}
+
+template <typename Tp, std::size_t Channels>
+static std::vector<Tp> frames(std::size_t first, std::size_t n)
+{
+	std::vector<Tp> v;
+	for(std::size_t f = first; f < first + n; f++)
+		for(std::size_t c = 0; c < Channels; c++)
+			v.push_back(sample<Tp>(f, c));
+	return v;
+}
+
+template <typename Tp, std::size_t Channels>
+static void round_trip()
+{
+	cc::multichannel_fifo<Tp, Channels, 50> data;
+
+	// Start at an odd offset, such that the next push wraps and has a scalar tail
+	const auto a = frames<Tp, Channels>(0, 37);
+	data.push_list(a.data(), 37);
+	data.discard(37);
+
+	const auto b = frames<Tp, Channels>(100, 43);
+	data.push_list(b.data(), 43);
+	ASSERT_EQ(data.size(), 43);
+	ASSERT_EQ(data.first_segment_size(), 13);
+	ASSERT_EQ(data.second_segment_size(), 30);
+
+	for(std::size_t c = 0; c < Channels; c++) {
+		for(std::size_t f = 0; f < 13; f++)
+			ASSERT_EQ(data.first_segment(c)[f], (sample<Tp>(100 + f, c)));
+		for(std::size_t f = 0; f < 30; f++)
+			ASSERT_EQ(data.second_segment(c)[f], (sample<Tp>(113 + f, c)));
+	}
+
+	std::vector<Tp> out(43 * Channels);
+	data.pop_list(out.data(), 3);
+	data.pop_list(out.data() + 3 * Channels);
+	ASSERT_TRUE(data.empty());
+	ASSERT_EQ(out, b);
+}
+
+TEST(MultichannelFifoTest, Int16)
+{
+	round_trip<std::int16_t, 32>(); // 8x8 transpose
+	round_trip<std::int16_t, 8>();
+	round_trip<std::int16_t, 4>(); // Scalar
+}
+
+TEST(MultichannelFifoTest, Float)
+{
+	round_trip<float, 4>(); // 4x4 transpose
+	round_trip<float, 12>();
+	round_trip<float, 3>(); // Scalar
+	round_trip<double, 2>();
+}
+
+TEST(MultichannelFifoTest, Frames)
+{
+	cc::multichannel_fifo<int, 3, 2> data;
+	ASSERT_EQ(data.channels(), 3);
+	ASSERT_EQ(data.max_size(), 2);
+
+	const int f1[] = {1, 2, 3};
+	const int f2[] = {4, 5, 6};
+	data.push(f1);
+	data.push(f2);
+	ASSERT_TRUE(data.full());
+	ASSERT_THROW({ data.push(f1); }, std::out_of_range);
+	ASSERT_THROW({ data.push_list(f1, 1); }, std::out_of_range);
+
+	int out[3];
+	data.pop(out);
+	ASSERT_EQ(out[2], 3);
+	data.pop(out);
+	ASSERT_EQ(out[0], 4);
+	ASSERT_THROW({ data.pop(out); }, std::out_of_range);
+	ASSERT_THROW({ data.pop_list(out, 1); }, std::out_of_range);
+}
+
+TEST(MultichannelFifoTest, Planar)
+{
+	cc::multichannel_fifo<float, 2, 8> data;
+
+	const float left[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+	const float right[] = {-1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f};
+	const float* in[] = {left, right};
+	data.push_planar(in, 6);
+	data.discard(4);
+	data.push_planar(in, 6); // Wraps
+	ASSERT_EQ(data.size(), 8);
+
+	float l[8], r[8];
+	float* out[] = {l, r};
+	data.pop_planar(out);
+	ASSERT_EQ(l[0], 5.0f);
+	ASSERT_EQ(r[1], -6.0f);
+	ASSERT_EQ(l[7], 6.0f);
+	ASSERT_EQ(r[2], -1.0f);
+	ASSERT_THROW({ data.pop_planar(out, 1); }, std::out_of_range);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "cc/numeric.hxx"
+
+TEST(NumericTest, Sum)
+{
+	cc::buffer<float, 3000> data;
+	for(int i = 0; i < 2999; i++)
+		data.push_back(static_cast<float>(i % 17) - 8.0f);
+	// 176 full periods of 17 sum to 0, then -8..-2 remain
+	ASSERT_EQ(cc::sum(data), -35.0f);
+	ASSERT_EQ(cc::sum<cc::summation::lanes>(data), -35.0f);
+	ASSERT_EQ(cc::sum<cc::summation::kahan>(data), -35.0f);
+
+	cc::buffer<std::int32_t, 100> ints;
+	for(int i = 1; i <= 100; i++)
+		ints.push_back(i);
+	ASSERT_EQ(cc::sum(ints), 5050);
+	ASSERT_EQ(cc::mean(ints), 50);
+
+	cc::buffer<double, 10> empty;
+	ASSERT_EQ(cc::sum(empty), 0.0);
+	ASSERT_THROW({ cc::mean(empty); }, std::out_of_range);
+	ASSERT_THROW({ cc::minmax(empty); }, std::out_of_range);
+}
+
+TEST(NumericTest, SmallIntegers)
+{
+	// 256 elements: the size doesn't fit in the element type, nor does the sum
+	cc::buffer<unsigned char, 512> bytes;
+	for(int i = 0; i < 256; i++)
+		bytes.push_back(static_cast<unsigned char>(i % 2 ? 110 : 100));
+	ASSERT_EQ(cc::mean(bytes), 105);
+	ASSERT_EQ(cc::variance(bytes), 25);
+
+	// Wrapped around the end of the fifo
+	cc::fifo<std::int8_t, 4> small;
+	small.push(0);
+	small.push(0);
+	small.discard(2);
+	for(std::int8_t v : {-100, -100, -120, -120})
+		small.push(v);
+	ASSERT_EQ(cc::mean(small), -110);
+	ASSERT_EQ(cc::variance(small), 100);
+
+	cc::buffer<std::uint8_t, 2> pair;
+	pair.push_back(200);
+	pair.push_back(200);
+	ASSERT_EQ(cc::mean(pair), 200);
+	ASSERT_EQ(cc::variance(pair), 0);
+
+	cc::fifo<std::int16_t, 4> empty;
+	ASSERT_THROW({ cc::variance(empty); }, std::out_of_range);
+}
+
+TEST(NumericTest, Precision)
+{
+	// 1 + 1e6 * 1e-8 in float: adding each term to 1 directly would lose all of them
+	cc::buffer<float, 1000001> data;
+	data.push_back(1.0f);
+	for(int i = 0; i < 1000000; i++)
+		data.push_back(1e-8f);
+
+	const double exact = 1.01;
+	const double lanes = cc::sum<cc::summation::lanes>(data);
+	const double pairwise = cc::sum<cc::summation::pairwise>(data);
+	const double kahan = cc::sum<cc::summation::kahan>(data);
+	ASSERT_NEAR(kahan, exact, 1e-6);
+	ASSERT_NEAR(pairwise, exact, 1e-5);
+	ASSERT_LE(std::abs(kahan - exact), std::abs(lanes - exact));
+}
+
+TEST(NumericTest, Statistics)
+{
+	cc::buffer<double, 64> data;
+	for(double v : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0})
+		data.push_back(v + 1e9); // Large offset, which breaks the single-pass formula
+	ASSERT_DOUBLE_EQ(cc::mean(data), 5.0 + 1e9);
+	ASSERT_DOUBLE_EQ(cc::variance(data), 4.0);
+	ASSERT_DOUBLE_EQ(cc::variance<cc::summation::kahan>(data), 4.0);
+
+	const auto mm = cc::minmax(data);
+	ASSERT_EQ(mm.first, 2.0 + 1e9);
+	ASSERT_EQ(mm.second, 9.0 + 1e9);
+
+	cc::buffer<float, 64> a, b;
+	for(int i = 0; i < 37; i++) {
+		a.push_back(static_cast<float>(i));
+		b.push_back(i % 2 ? 1.0f : -1.0f);
+	}
+	ASSERT_EQ(cc::dot(a, b), 18.0f * 18.0f - 18.0f * 19.0f); // Odd minus even
+	b.pop_back();
+	ASSERT_THROW({ cc::dot(a, b); }, std::out_of_range);
+}
+
+TEST(NumericTest, Fifo)
+{
+	cc::fifo<float, 50> data;
+	std::vector<float> values;
+	for(int i = 0; i < 40; i++)
+		data.push(0.0f);
+	data.discard(40);
+	for(int i = 0; i < 35; i++) {
+		values.push_back(static_cast<float>(i * 3 % 11));
+		data.push(values.back());
+	}
+	ASSERT_EQ(data.second_segment_size(), 25);
+
+	float expected = 0.0f;
+	for(float v : values)
+		expected += v;
+	ASSERT_EQ(cc::sum(data), expected);
+	ASSERT_EQ(cc::sum<cc::summation::kahan>(data), expected);
+	ASSERT_FLOAT_EQ(cc::mean(data), expected / 35.0f);
+
+	const auto mm = cc::minmax(data);
+	ASSERT_EQ(mm.first, 0.0f);
+	ASSERT_EQ(mm.second, 10.0f);
+
+	std::vector<float> ones(35, 1.0f);
+	ASSERT_EQ(cc::dot(data, ones.data()), expected);
+
+	float m = expected / 35.0f, var = 0.0f;
+	for(float v : values)
+		var += (v - m) * (v - m);
+	ASSERT_FLOAT_EQ(cc::variance(data), var / 35.0f);
+
+	std::vector<float> scan(35);
+	cc::inclusive_scan(data, scan.data());
+	ASSERT_EQ(scan[0], values[0]);
+	ASSERT_EQ(scan[34], expected);
+	cc::exclusive_scan(data, scan.data(), 1.0f);
+	ASSERT_EQ(scan[0], 1.0f);
+	ASSERT_EQ(scan[34], 1.0f + expected - values[34]);
+}
+
+template <typename Tp, cc::summation S>
+static void check_scan()
+{
+	cc::buffer<Tp, 100> inc, exc;
+	for(int i = 0; i < 99; i++) {
+		inc.push_back(static_cast<Tp>(i % 7));
+		exc.push_back(static_cast<Tp>(i % 7));
+	}
+	cc::inclusive_scan<S>(inc);
+	cc::exclusive_scan<S>(exc, Tp(5));
+
+	Tp acc = 0;
+	for(int i = 0; i < 99; i++) {
+		ASSERT_EQ(exc[i], acc + Tp(5));
+		acc += static_cast<Tp>(i % 7);
+		ASSERT_EQ(inc[i], acc);
+	}
+}
+
+TEST(NumericTest, Scan)
+{
+	check_scan<float, cc::summation::pairwise>();
+	check_scan<float, cc::summation::kahan>();
+	check_scan<double, cc::summation::lanes>();
+	check_scan<std::int32_t, cc::summation::pairwise>();
+	check_scan<std::uint32_t, cc::summation::pairwise>();
+	check_scan<std::int16_t, cc::summation::pairwise>();
+}
+
+TEST(NumericTest, KahanScanWrapped)
+{
+	// 1 followed by tiny terms, whose sum only survives with the compensation
+	std::vector<float> values(64, 1e-8f);
+	values[0] = 1.0f;
+	std::vector<float> expected(64);
+	{
+		cc::buffer<float, 64> b;
+		b.append(values.data(), values.data() + 64);
+		cc::inclusive_scan<cc::summation::kahan>(b);
+		std::copy(b.begin(), b.end(), expected.begin());
+	}
+
+	// The result must not depend on where the fifo wraps
+	for(std::size_t offset : {0, 1, 30, 63}) {
+		cc::fifo<float, 64> f;
+		for(std::size_t i = 0; i < offset; i++)
+			f.push(0.0f);
+		f.discard(offset);
+		f.push_list(values.data(), values.data() + 64);
+
+		std::vector<float> out(64);
+		cc::inclusive_scan<cc::summation::kahan>(f, out.data());
+		ASSERT_EQ(out, expected) << "offset " << offset;
+	}
+}
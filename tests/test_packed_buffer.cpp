@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "cc/packed_buffer.hxx"
+
+TEST(PackedBufferTest, Basic)
+{
+	cc::packed_buffer<12, 100> data;
+	ASSERT_EQ(data.size(), 0);
+	ASSERT_EQ(data.max_size(), 100);
+	ASSERT_TRUE(data.empty());
+	ASSERT_LE(sizeof(data), 100 * 12 / 8 + 2 * 8 + sizeof(std::size_t));
+
+	for(unsigned i = 0; i < 100; i++)
+		data.push_back((i * 41u) & 0xFFFu);
+	ASSERT_EQ(data.size(), 100);
+	ASSERT_EQ(data.free(), 0);
+	ASSERT_THROW({ data.push_back(0); }, std::out_of_range);
+
+	for(unsigned i = 0; i < 100; i++)
+		ASSERT_EQ(data.get(i), (i * 41u) & 0xFFFu);
+	ASSERT_THROW({ data.get(100); }, std::out_of_range);
+
+	data.set(5, 0xFFF);
+	data.set(6, 0x1234); // Truncated
+	ASSERT_EQ(data.get(4), (4u * 41u) & 0xFFFu);
+	ASSERT_EQ(data.get(5), 0xFFFu);
+	ASSERT_EQ(data.get(6), 0x234u);
+	ASSERT_EQ(data.get(7), (7u * 41u) & 0xFFFu);
+
+	ASSERT_EQ(data.pop_back(), (99u * 41u) & 0xFFFu);
+	ASSERT_EQ(data.size(), 99);
+
+	data.reset();
+	ASSERT_TRUE(data.empty());
+	data.assign(3, 7);
+	ASSERT_EQ(data.size(), 4);
+	ASSERT_EQ(data[3], 7u);
+}
+
+TEST(PackedBufferTest, Widths)
+{
+	cc::packed_buffer<1, 130> bits;
+	cc::packed_buffer<63, 10> wide;
+
+	for(unsigned i = 0; i < 130; i++)
+		bits.push_back(i % 3 == 0);
+	for(std::uint64_t i = 0; i < 10; i++)
+		wide.push_back(~std::uint64_t(0) / (i + 1));
+
+	for(unsigned i = 0; i < 130; i++)
+		ASSERT_EQ(bits[i], i % 3 == 0 ? 1u : 0u);
+	for(std::uint64_t i = 0; i < 10; i++)
+		ASSERT_EQ(wide[i], (~std::uint64_t(0) / (i + 1)) & (~std::uint64_t(0) >> 1));
+}
+
+TEST(PackedBufferTest, Unpack)
+{
+	cc::packed_buffer<12, 1000> data;
+	for(unsigned i = 0; i < 995; i++)
+		data.push_back(i * 7919u);
+
+	cc::buffer<std::uint16_t, 1000> out16;
+	out16.push_back(1);
+	data.unpack(out16);
+	ASSERT_EQ(out16.size(), 996);
+	ASSERT_EQ(out16[0], 1);
+	for(unsigned i = 0; i < 995; i++)
+		ASSERT_EQ(out16[i + 1], (i * 7919u) & 0xFFFu);
+
+	cc::buffer<std::uint32_t, 1000> out32;
+	data.unpack(out32);
+	cc::buffer<std::uint64_t, 1000> out64;
+	data.unpack(out64);
+	for(unsigned i = 0; i < 995; i++) {
+		ASSERT_EQ(out32[i], (i * 7919u) & 0xFFFu);
+		ASSERT_EQ(out64[i], (i * 7919u) & 0xFFFu);
+	}
+
+	cc::buffer<std::uint32_t, 10> small;
+	ASSERT_THROW({ data.unpack(small); }, std::out_of_range);
+}
+
+TEST(PackedBufferTest, Unpack25)
+{
+	cc::packed_buffer<25, 64> data;
+	for(unsigned i = 0; i < 64; i++)
+		data.push_back(0x1FFFFFFu - i * 12345u);
+
+	cc::buffer<std::int32_t, 64> out;
+	data.unpack(out);
+	for(unsigned i = 0; i < 64; i++)
+		ASSERT_EQ(out[i], static_cast<std::int32_t>(0x1FFFFFFu - i * 12345u));
+}
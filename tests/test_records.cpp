@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cc/records.hxx"
+#include "cc/registry.hxx"
+
+static void push_string(cc::fifo<char, 16>& data, const std::string& s)
+{
+	data.push_list(s.data(), s.data() + s.size());
+}
+
+static std::string join(const cc::record_splitter<16>::record_type& record)
+{
+	return std::string(record.first) + std::string(record.second);
+}
+
+TEST(RecordsTest, Lines)
+{
+	cc::fifo<char, 16> data;
+	push_string(data, "ab\ncde\nf");
+
+	cc::record_splitter<16> lines(data);
+	cc::record_splitter<16>::record_type line;
+
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(line.first, "ab");
+	ASSERT_TRUE(line.second.empty());
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(line.first, "cde");
+	ASSERT_FALSE(lines.next(line));
+
+	// Nothing is removed until released
+	ASSERT_EQ(data.size(), 8);
+	ASSERT_EQ(lines.pending(), 7);
+	lines.release();
+	ASSERT_EQ(data.size(), 1);
+
+	push_string(data, "gh\n");
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(line.first, "fgh");
+	lines.release();
+	ASSERT_TRUE(data.empty());
+}
+
+TEST(RecordsTest, Wrap)
+{
+	cc::fifo<char, 16> data;
+	push_string(data, "0123456789\n");
+	cc::record_splitter<16> lines(data);
+	ASSERT_EQ(lines.for_each([](const auto&) {}), 1);
+
+	// Record crosses the end of the underlying array
+	push_string(data, "abcdefghij\nxy\n");
+	std::vector<std::string> records;
+	ASSERT_EQ(lines.for_each([&](const auto& r) { records.push_back(join(r)); }), 2);
+	ASSERT_EQ(records[0], "abcdefghij");
+	ASSERT_EQ(records[1], "xy");
+	ASSERT_TRUE(data.empty());
+}
+
+TEST(RecordsTest, WrapSplit)
+{
+	cc::fifo<char, 16> data;
+	push_string(data, "0123456789012\n");
+	data.discard(14);
+	push_string(data, "abcdef;");
+
+	cc::record_splitter<16> records(data, ';');
+	cc::record_splitter<16>::record_type record;
+	ASSERT_TRUE(records.next(record));
+	ASSERT_EQ(record.first, "ab");
+	ASSERT_EQ(record.second, "cdef");
+	ASSERT_FALSE(records.next(record));
+}
+
+TEST(RecordsTest, Empty)
+{
+	cc::fifo<char, 16> data;
+	push_string(data, "\n\nx");
+
+	cc::record_splitter<16> lines(data);
+	cc::record_splitter<16>::record_type line;
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(join(line), "");
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(join(line), "");
+	ASSERT_FALSE(lines.next(line));
+	lines.release();
+	ASSERT_EQ(data.size(), 1);
+}
+
+TEST(RecordsTest, Long)
+{
+	// Exercise the vectorized search
+	cc::fifo<char, 256> data;
+	std::string s(100, 'x');
+	s += '\n';
+	s += std::string(70, 'y');
+	data.push_list(s.data(), s.data() + s.size());
+
+	cc::record_splitter<256> lines(data);
+	cc::record_splitter<256>::record_type line;
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(line.first.size(), 100);
+	ASSERT_FALSE(lines.next(line));
+
+	data.push('\n');
+	ASSERT_TRUE(lines.next(line));
+	ASSERT_EQ(line.first, std::string(70, 'y'));
+}
+
+TEST(RecordsTest, Traced)
+{
+	cc::monitored<cc::fifo, char, 16> data("records");
+	const std::string s = "ab\ncd\ne";
+	data.push_list(s.data(), s.data() + s.size());
+
+	cc::record_splitter lines(data); // Deduced from the base fifo, with its trace policy
+	std::vector<std::string> seen;
+	ASSERT_EQ(lines.for_each([&](const auto& r) { seen.push_back(join(r)); }), 2);
+	ASSERT_EQ(seen, (std::vector<std::string>{"ab", "cd"}));
+
+	// Released records are counted as pops
+	const auto stats = cc::registry::instance().snapshot();
+	const auto it = std::find_if(stats.begin(), stats.end(),
+				     [](const cc::container_stats& c) { return c.name == "records"; });
+	ASSERT_NE(it, stats.end());
+	ASSERT_EQ(it->pops, 6);
+	ASSERT_EQ(it->size, 1);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "cc/numeric.hxx"
+#include "cc/registry.hxx"
+
+TEST(RegistryTest, Snapshot)
+{
+	auto& registry = cc::registry::instance();
+	const std::size_t before = registry.size();
+	{
+		cc::monitored<cc::fifo, int, 4> queue("ingress");
+		cc::monitored<cc::buffer, float, 8> samples("adc \"0\"");
+		ASSERT_EQ(registry.size(), before + 2);
+
+		const int values[] = {1, 2, 3, 4};
+		queue.push_list(values, values + 4);
+		queue.pop();
+		queue.push(5);
+		queue.discard(3);
+		samples.push_back(1.0f);
+		samples.push_back(2.0f);
+		ASSERT_EQ(cc::sum(samples), 3.0f); // Still a buffer to all algorithms
+
+		const auto stats = registry.snapshot();
+		ASSERT_EQ(stats.size(), before + 2);
+		const cc::container_stats& q = stats[before];
+		ASSERT_EQ(q.name, "ingress");
+		ASSERT_STREQ(q.kind, "fifo");
+		ASSERT_EQ(q.capacity, 4);
+		ASSERT_EQ(q.size, 1);
+		ASSERT_EQ(q.high_water, 4);
+		ASSERT_EQ(q.pushes, 5);
+		ASSERT_EQ(q.pops, 4);
+		ASSERT_EQ(q.full, 2);
+		ASSERT_GT(q.push_rate, 0.0);
+
+		const cc::container_stats& s = stats[before + 1];
+		ASSERT_STREQ(s.kind, "buffer");
+		ASSERT_EQ(s.size, 2);
+		ASSERT_EQ(s.full, 0);
+
+		// Rates restart at each snapshot
+		ASSERT_EQ(registry.snapshot()[before].push_rate, 0.0);
+
+		std::ostringstream prom;
+		cc::registry::write_prometheus(prom, stats);
+		const std::string text = prom.str();
+		ASSERT_NE(text.find("# TYPE cc_container_pushes_total counter\n"),
+			  std::string::npos);
+		ASSERT_NE(text.find("cc_container_high_water{name=\"ingress\",kind=\"fifo\"} 4\n"),
+			  std::string::npos);
+		// Quotes in names are escaped
+		ASSERT_NE(text.find("cc_container_size{name=\"adc \\\"0\\\"\",kind=\"buffer\"}"),
+			  std::string::npos);
+
+		std::ostringstream json;
+		cc::registry::write_json(json, stats);
+		const std::string expected = "{\"name\": \"ingress\", \"kind\": \"fifo\", "
+					     "\"capacity\": 4, \"size\": 1, \"high_water\": 4, "
+					     "\"pushes\": 5, \"pops\": 4, \"full\": 2";
+		ASSERT_NE(json.str().find(expected), std::string::npos);
+
+		const std::string path = testing::TempDir() + "cc_registry.json";
+		registry.write(path, cc::registry::format::json);
+		std::ifstream in(path);
+		std::string first;
+		std::getline(in, first);
+		ASSERT_EQ(first, "[");
+		std::remove(path.c_str());
+	}
+	ASSERT_EQ(registry.size(), before);
+}
+
+TEST(RegistryTest, Reset)
+{
+	auto& registry = cc::registry::instance();
+	const std::size_t before = registry.size();
+	cc::monitored<cc::buffer, int, 8> frame("frame");
+	cc::monitored<cc::fifo, int, 4> queue("queue");
+
+	// Fill, process, reset: the cycle of a buffer
+	for(int i = 0; i < 5; i++)
+		frame.push_back(i);
+	frame.reset();
+	frame.fill_all(0);
+	frame.reset(2);
+	frame.assign(3, 1);
+	queue.push(1);
+	queue.push(2);
+	queue.truncate();
+
+	const auto stats = registry.snapshot();
+	const cc::container_stats& f = stats[before];
+	ASSERT_EQ(f.size, 4);
+	ASSERT_EQ(f.high_water, 8);
+	ASSERT_EQ(f.pushes, 15);
+	ASSERT_EQ(f.pops, 11);
+	ASSERT_EQ(f.full, 1);
+
+	const cc::container_stats& q = stats[before + 1];
+	ASSERT_EQ(q.size, 0);
+	ASSERT_EQ(q.pushes, 2);
+	ASSERT_EQ(q.pops, 2);
+}
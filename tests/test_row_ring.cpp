@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "cc/row_ring.hxx"
+
+TEST(RowRingTest, Layout)
+{
+	cc::row_ring<float, 10, 4> data;
+	ASSERT_EQ(data.stride, 16);
+	ASSERT_EQ(data.max_size(), 4);
+	ASSERT_EQ(data.width(), 10);
+	ASSERT_TRUE(data.empty());
+
+	for(int i = 0; i < 4; i++)
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(data.push()) % 64, 0);
+	ASSERT_TRUE(data.full());
+
+	// Element sizes that don't divide a cache line are not padded
+	ASSERT_EQ((cc::row_ring<std::array<char, 3>, 10, 4>::stride), 10);
+}
+
+TEST(RowRingTest, PushWrap)
+{
+	cc::row_ring<int, 3, 4> data;
+
+	for(int r = 0; r < 7; r++) {
+		const int row[] = {r, r * 10, r * 100};
+		data.push(row);
+	}
+	ASSERT_EQ(data.size(), 4);
+	ASSERT_EQ(data[0][1], 30); // Rows 0-2 were dropped
+	ASSERT_EQ(data.back()[2], 600);
+
+	// Window over the wrap of the ring
+	int* const* w = data.window(1, 3);
+	ASSERT_EQ(w[0][0], 4);
+	ASSERT_EQ(w[1][0], 5);
+	ASSERT_EQ(w[2][0], 6);
+	ASSERT_THROW({ data.window(2, 3); }, std::out_of_range);
+
+	// Write in place
+	int* row = data.push();
+	row[0] = 7;
+	ASSERT_EQ(data.window(0, 4)[3][0], 7);
+	ASSERT_EQ(data[0][0], 4);
+}
+
+TEST(RowRingTest, Pop)
+{
+	cc::row_ring<double, 2, 3> data;
+	ASSERT_THROW({ data.pop(); }, std::out_of_range);
+	ASSERT_THROW({ data.back(); }, std::out_of_range);
+
+	data.push()[0] = 1.0;
+	data.push()[0] = 2.0;
+	data.pop();
+	ASSERT_EQ(data.size(), 1);
+	ASSERT_EQ(data[0][0], 2.0);
+
+	const auto copy = data;
+	data.truncate();
+	ASSERT_TRUE(data.empty());
+	ASSERT_EQ(copy.window(0, 1)[0][0], 2.0);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include "cc/shm_fifo.hxx"
+
+extern "C" int test_shm_queue_sum(void* mem, size_t bytes);
+extern "C" int test_shm_queue_check_zero_capacity(void* mem, size_t bytes);
+
+typedef cc::shm_fifo<std::int32_t, 8> queue_type;
+
+TEST(ShmFifoTest, PushPop)
+{
+	alignas(64) unsigned char mem[queue_type::bytes()];
+	auto q = queue_type::create(mem, sizeof(mem));
+
+	ASSERT_EQ(q.max_size(), 8);
+	ASSERT_TRUE(q.empty());
+
+	for(std::int32_t i = 0; i < 8; i++)
+		q.push(i);
+	ASSERT_TRUE(q.full());
+	ASSERT_THROW({ q.push(8); }, std::out_of_range);
+
+	ASSERT_EQ(q.pop(), 0);
+	ASSERT_EQ(q.pop(), 1);
+	ASSERT_EQ(q.size(), 6);
+
+	std::int32_t list[3] = {10, 11, 12};
+	q.push_list(list, list + 2);
+	ASSERT_EQ(q.size(), 8);
+
+	std::int32_t out[8] = {};
+	q.pop_list(out);
+	ASSERT_EQ(out[0], 2);
+	ASSERT_EQ(out[5], 7);
+	ASSERT_EQ(out[6], 10);
+	ASSERT_EQ(out[7], 11);
+	ASSERT_TRUE(q.empty());
+	ASSERT_THROW({ q.pop(); }, std::out_of_range);
+}
+
+TEST(ShmFifoTest, Attach)
+{
+	alignas(64) unsigned char mem[queue_type::bytes()] = {};
+	ASSERT_THROW({ queue_type::attach(mem, sizeof(mem)); }, std::invalid_argument);
+
+	auto producer = queue_type::create(mem, sizeof(mem));
+	producer.push(42);
+
+	auto consumer = queue_type::attach(mem, sizeof(mem));
+	ASSERT_EQ(consumer.pop(), 42);
+
+	ASSERT_THROW(
+		{ (cc::shm_fifo<std::int16_t, 8>::attach(mem, sizeof(mem))); },
+		std::invalid_argument);
+	ASSERT_THROW(
+		{ (cc::shm_fifo<std::int32_t, 4>::attach(mem, sizeof(mem))); },
+		std::invalid_argument);
+}
+
+TEST(ShmFifoTest, Peek)
+{
+	alignas(64) unsigned char mem[queue_type::bytes()];
+	auto q = queue_type::create(mem, sizeof(mem));
+
+	for(std::int32_t i = 0; i < 6; i++)
+		q.push(i);
+	q.discard(5);
+	for(std::int32_t i = 6; i < 10; i++)
+		q.push(i);
+
+	const std::int32_t* first = nullptr;
+	ASSERT_EQ(q.peek(first), 3);
+	ASSERT_EQ(first[0], 5);
+	ASSERT_EQ(first[2], 7);
+	q.discard(3);
+	ASSERT_EQ(q.peek(first), 2);
+	ASSERT_EQ(first[0], 8);
+}
+
+TEST(ShmFifoTest, CInterface)
+{
+	alignas(64) unsigned char mem[queue_type::bytes()];
+	auto q = queue_type::create(mem, sizeof(mem));
+
+	// Wrap around first
+	for(std::int32_t i = 0; i < 5; i++)
+		q.push(0);
+	q.discard(5);
+	for(std::int32_t i = 1; i <= 6; i++)
+		q.push(i);
+
+	ASSERT_EQ(test_shm_queue_sum(mem, sizeof(mem)), 6);
+	ASSERT_EQ(q.size(), 1);
+	ASSERT_EQ(q.pop(), 21);
+}
+
+TEST(ShmFifoTest, CorruptHeader)
+{
+	alignas(64) unsigned char mem[queue_type::bytes()];
+	ASSERT_EQ(test_shm_queue_check_zero_capacity(mem, sizeof(mem)), -1);
+
+	auto* q = reinterpret_cast<cc_shm_queue*>(mem);
+	const auto reset = [&] {
+		ASSERT_EQ(cc_shm_queue_init(mem, sizeof(mem), 8, sizeof(std::int32_t)), 0);
+		ASSERT_EQ(cc_shm_queue_check(mem, sizeof(mem), sizeof(std::int32_t)), 0);
+	};
+
+	reset();
+	q->data_offset = 0; // Data over the header
+	ASSERT_EQ(cc_shm_queue_check(mem, sizeof(mem), sizeof(std::int32_t)), -1);
+
+	reset();
+	q->capacity = (UINT64_MAX >> 2) + 1; // Wraps to 0 bytes
+	ASSERT_EQ(cc_shm_queue_check(mem, sizeof(mem), sizeof(std::int32_t)), -1);
+
+	reset();
+	q->element_size = 0;
+	ASSERT_EQ(cc_shm_queue_check(mem, sizeof(mem), 0), -1);
+
+	ASSERT_EQ(cc_shm_queue_bytes(UINT64_MAX, 4), SIZE_MAX);
+	ASSERT_EQ(cc_shm_queue_init(mem, sizeof(mem), UINT64_MAX / 2, 4), -1);
+	ASSERT_EQ(cc_shm_queue_init(mem, sizeof(mem), 0, 4), -1);
+}
@@ -0,0 +1,38 @@
+/* Consumer/producer written against the plain C interface, used by test_shm_fifo.cpp. */
+#include "cc/shm_queue.h"
+
+/* Check a valid queue whose header was then overwritten with capacity 0. */
+int test_shm_queue_check_zero_capacity(void* mem, size_t bytes)
+{
+	cc_shm_queue* q = (cc_shm_queue*)mem;
+
+	if(cc_shm_queue_init(mem, bytes, 4, sizeof(int32_t)))
+		return -2;
+	q->capacity = 0;
+	return cc_shm_queue_check(mem, bytes, sizeof(int32_t));
+}
+
+/* Pop all int32 elements, and push back their sum. Returns the number of popped elements. */
+int test_shm_queue_sum(void* mem, size_t bytes)
+{
+	cc_shm_queue* q = (cc_shm_queue*)mem;
+	const void* first;
+	uint64_t n;
+	int32_t sum = 0;
+	int count = 0;
+
+	if(cc_shm_queue_check(mem, bytes, sizeof(int32_t)))
+		return -1;
+
+	while((n = cc_shm_queue_peek(q, &first)) > 0) {
+		for(uint64_t i = 0; i < n; i++)
+			sum += ((const int32_t*)first)[i];
+		cc_shm_queue_release(q, n);
+		count += (int)n;
+	}
+
+	if(cc_shm_queue_push(q, &sum))
+		return -1;
+
+	return count;
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "cc/sort.hxx"
+
+/**
+ * Fill `b` with `n` random values, sort it with `cc::sort`, and compare with `std::sort`.
+ */
+template <typename Tp, std::size_t Nm>
+static void check_sort(std::size_t n, Tp lo, Tp hi)
+{
+	std::mt19937_64 rng(n);
+	typename std::conditional<
+		std::is_floating_point<Tp>::value,
+		std::uniform_real_distribution<Tp>,
+		std::uniform_int_distribution<long long>>::type dist(lo, hi);
+
+	cc::buffer<Tp, Nm> b;
+	for(std::size_t i = 0; i < n; i++)
+		b.push_back(static_cast<Tp>(dist(rng)));
+
+	std::vector<Tp> expected(b.begin(), b.end());
+	std::sort(expected.begin(), expected.end());
+
+	cc::sort(b);
+	ASSERT_EQ(b.size(), n);
+	ASSERT_TRUE(std::equal(b.begin(), b.end(), expected.begin()));
+}
+
+TEST(SortTest, Network)
+{
+	check_sort<std::uint64_t, 64>(64, 0, std::numeric_limits<long long>::max());
+	check_sort<std::uint64_t, 64>(37, 0, 1000);
+	check_sort<std::int32_t, 20>(20, -100, 100);
+	check_sort<std::int8_t, 5>(5, -128, 127);
+	check_sort<float, 33>(30, -1e6f, 1e6f);
+	check_sort<double, 1>(1, -1.0, 1.0);
+	check_sort<std::uint16_t, 8>(0, 0, 1);
+}
+
+TEST(SortTest, Radix)
+{
+	check_sort<float, 8192>(8192, -1e6f, 1e6f);
+	check_sort<float, 8192>(5000, 0.0f, 1.0f);
+	check_sort<double, 1000>(999, -1e300, 1e300);
+	check_sort<std::int64_t, 500>(500, std::numeric_limits<long long>::min(), 10);
+	check_sort<std::uint16_t, 3000>(3000, 0, 255); // Skips the upper pass
+	check_sort<std::int8_t, 100>(100, -128, 127);
+}
+
+TEST(SortTest, FloatOrder)
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float inf = std::numeric_limits<float>::infinity();
+
+	cc::buffer<float, 16> small;
+	cc::buffer<float, 100> large;
+	for(float v : {nan, 1.0f, 0.0f, -inf, -0.0f, inf, -2.5f}) {
+		small.push_back(v);
+		large.push_back(v);
+	}
+	cc::sort(small);
+	cc::sort(large);
+
+	for(auto* b : {small.data(), large.data()}) {
+		ASSERT_EQ(b[0], -inf);
+		ASSERT_EQ(b[1], -2.5f);
+		ASSERT_TRUE(std::signbit(b[2]));
+		ASSERT_EQ(b[2], 0.0f);
+		ASSERT_FALSE(std::signbit(b[3]));
+		ASSERT_EQ(b[4], 1.0f);
+		ASSERT_EQ(b[5], inf);
+		ASSERT_TRUE(std::isnan(b[6]));
+	}
+}
+
+TEST(SortTest, Scratch)
+{
+	cc::buffer<std::uint32_t, 300> b, scratch;
+	for(std::uint32_t i = 0; i < 300; i++)
+		b.push_back((i * 2654435761u) ^ 0x5A5A5A5Au);
+
+	cc::radix_sort(b, scratch);
+	ASSERT_TRUE(std::is_sorted(b.begin(), b.end()));
+
+	cc::buffer<std::uint32_t, 64> nb;
+	for(std::size_t i = 0; i < 64; i++)
+		nb.push_back(b[299 - i * 4]);
+	cc::network_sort(nb);
+	ASSERT_TRUE(std::is_sorted(nb.begin(), nb.end()));
+	ASSERT_EQ(nb[0], b[47]);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "cc/timed_fifo.hxx"
+
+namespace {
+
+struct manual_clock {
+	static std::uint64_t ticks;
+
+	static std::uint64_t now() noexcept
+	{
+		return ticks;
+	}
+
+	static std::uint64_t to_ns(std::uint64_t t) noexcept
+	{
+		return t * 10;
+	}
+};
+
+std::uint64_t manual_clock::ticks = 0;
+
+} // namespace
+
+TEST(TimedFifoTest, Sojourn)
+{
+	cc::timed_fifo<int, 8, manual_clock> f;
+	manual_clock::ticks = 100;
+	f.push(1);
+	manual_clock::ticks = 150;
+	const int values[] = {2, 3, 4};
+	f.push_list(values, values + 3);
+
+	manual_clock::ticks = 160;
+	ASSERT_EQ(f.front_age(), 600);
+	ASSERT_EQ(f.pop(), 1); // 60 ticks
+	int out[2];
+	f.pop_list(out, 2); // 10 ticks each
+	ASSERT_EQ(out[1], 3);
+	manual_clock::ticks = 250;
+	f.discard(1); // 100 ticks
+	ASSERT_TRUE(f.empty());
+	ASSERT_THROW({ f.front_age(); }, std::out_of_range);
+
+	const auto& h = f.sojourn();
+	ASSERT_EQ(h.count(), 4);
+	ASSERT_EQ(h.max(), 1000);
+	ASSERT_EQ(h.value_at_percentile(0), 100);
+	ASSERT_EQ(h.value_at_percentile(50), 100);
+	ASSERT_EQ(h.value_at_percentile(75), 603); // Two significant digits
+	ASSERT_EQ(h.value_at_percentile(100), 1000);
+
+	// Wraps around, with the stamps in lockstep
+	for(int i = 0; i < 20; i++) {
+		manual_clock::ticks = 1000 + i;
+		f.push(i);
+		f.push(i);
+		manual_clock::ticks = 1002 + i;
+		ASSERT_EQ(f.pop(), i);
+		ASSERT_EQ(f.pop(), i);
+	}
+	ASSERT_EQ(f.sojourn().count(), 44);
+	ASSERT_EQ(f.sojourn().value_at_percentile(50), 20);
+
+	f.sojourn().reset();
+	ASSERT_THROW({ f.sojourn().value_at_percentile(50); }, std::out_of_range);
+}
+
+TEST(TimedFifoTest, Clocks)
+{
+	const std::uint64_t c0 = cc::coarse_clock::now();
+	const std::uint64_t t0 = cc::tsc_clock::now();
+	cc::timed_fifo<int, 4, cc::tsc_clock> f;
+	f.push(1);
+	ASSERT_LT(f.front_age(), 1000000000u);
+	ASSERT_GE(cc::tsc_clock::now(), t0);
+	ASSERT_GE(cc::coarse_clock::now(), c0);
+	// The calibration took about a millisecond
+	ASSERT_GT(cc::tsc_clock::to_ns(cc::tsc_clock::now() - t0), 500000u);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "cc/top_k.hxx"
+
+template <typename Tp, typename Compare>
+static void check_top_k(std::size_t n)
+{
+	std::mt19937 rng(static_cast<unsigned>(n));
+	std::uniform_int_distribution<int> dist(-1000000, 1000000);
+	std::vector<Tp> values(n);
+	for(auto& v : values)
+		v = static_cast<Tp>(dist(rng));
+
+	cc::top_k<Tp, 100, Compare> batch;
+	cc::top_k<Tp, 100, Compare> single;
+	batch.offer(values.data(), values.data() + 10); // Fills up first
+	batch.offer(values.data() + 10, values.data() + n);
+	for(const auto& v : values)
+		single.offer(v);
+
+	// Best first, like a partial sort with the reversed ordering
+	const Compare comp;
+	std::partial_sort(
+		values.begin(), values.begin() + 100, values.end(),
+		[&](const Tp& a, const Tp& b) { return comp(b, a); });
+
+	const auto a = batch.sorted();
+	const auto b = single.sorted();
+	ASSERT_EQ(a.size(), 100);
+	ASSERT_TRUE(std::equal(a.begin(), a.end(), values.begin()));
+	ASSERT_TRUE(std::equal(b.begin(), b.end(), values.begin()));
+	ASSERT_EQ(batch.threshold(), values[99]);
+}
+
+TEST(TopKTest, Batch)
+{
+	check_top_k<float, std::less<float>>(100000);
+	check_top_k<float, std::greater<float>>(5003);
+	check_top_k<double, std::less<double>>(20001);
+	check_top_k<int, std::less<int>>(30000);
+	check_top_k<int, std::greater<>>(30000);
+	check_top_k<long, std::less<long>>(1000); // Scalar
+}
+
+TEST(TopKTest, Partial)
+{
+	cc::top_k<int, 4> data;
+	ASSERT_TRUE(data.empty());
+	ASSERT_THROW({ data.threshold(); }, std::out_of_range);
+
+	const int values[] = {5, 1, 9};
+	ASSERT_EQ(data.offer(values, values + 3), 3);
+	ASSERT_EQ(data.size(), 3);
+	ASSERT_EQ(data.threshold(), 1);
+
+	ASSERT_TRUE(data.offer(0)); // Not full yet
+	ASSERT_TRUE(data.full());
+	ASSERT_FALSE(data.offer(0));
+	ASSERT_TRUE(data.offer(2));
+	ASSERT_EQ(data.threshold(), 1);
+
+	const auto s = data.sorted();
+	ASSERT_EQ(s[0], 9);
+	ASSERT_EQ(s[3], 1);
+
+	data.reset();
+	ASSERT_TRUE(data.empty());
+}
+
+TEST(TopKTest, Custom)
+{
+	struct event {
+		int id;
+		float score;
+	};
+	auto by_score = [](const event& a, const event& b) { return a.score < b.score; };
+	cc::top_k<event, 2, decltype(by_score)> data(by_score);
+
+	const event events[] = {{1, 0.5f}, {2, 3.0f}, {3, 1.0f}, {4, 2.0f}};
+	data.offer(events, events + 4);
+	const auto s = data.sorted();
+	ASSERT_EQ(s[0].id, 2);
+	ASSERT_EQ(s[1].id, 4);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cc/buffer.hxx"
+#include "cc/fifo.hxx"
+#include "cc/numeric.hxx"
+#include "cc/trace.hxx"
+
+namespace {
+
+std::vector<std::string> events;
+
+struct record_trace {
+	static constexpr bool enabled = true;
+
+	static void push(const char* container, const void*, std::size_t n, std::size_t size)
+	{
+		events.push_back(std::string(container) + " push " + std::to_string(n) + " "
+				 + std::to_string(size));
+	}
+
+	static void pop(const char* container, const void*, std::size_t n, std::size_t size)
+	{
+		events.push_back(std::string(container) + " pop " + std::to_string(n) + " "
+				 + std::to_string(size));
+	}
+
+	static void full(const char* container, const void*, std::size_t size)
+	{
+		events.push_back(std::string(container) + " full " + std::to_string(size));
+	}
+
+	static void empty(const char* container, const void*)
+	{
+		events.push_back(std::string(container) + " empty");
+	}
+};
+
+} // namespace
+
+TEST(TraceTest, Fifo)
+{
+	events.clear();
+	cc::fifo<int, 4, record_trace> f;
+	const int values[] = {1, 2, 3};
+	f.push(0);
+	f.push_list(values, values + 3);
+	ASSERT_THROW({ f.push(4); }, std::out_of_range);
+	f.pop();
+	f.discard(2);
+	int out[1];
+	f.pop_list(out);
+
+	const std::vector<std::string> expected = {
+		"fifo push 1 1", "fifo push 3 4", "fifo full 4",
+		"fifo pop 1 3",  "fifo pop 2 1",  "fifo pop 1 0", "fifo empty",
+	};
+	ASSERT_EQ(events, expected);
+}
+
+TEST(TraceTest, Buffer)
+{
+	events.clear();
+	cc::buffer<int, 3, record_trace> b;
+	const int values[] = {1, 2};
+	b.push_back(0);
+	b.append(values, values + 2);
+	b.compact_if([](int v) { return v == 1; });
+	b.pop_back();
+
+	const std::vector<std::string> expected = {
+		"buffer push 1 1", "buffer push 2 3", "buffer full 3",
+		"buffer pop 2 1",  "buffer pop 1 0",  "buffer empty",
+	};
+	ASSERT_EQ(events, expected);
+
+	// Traced containers work with all algorithms
+	events.clear();
+	b.append(values, values + 2);
+	ASSERT_EQ(cc::sum(b), 3);
+	ASSERT_EQ(events.size(), 1);
+}
+
+TEST(TraceTest, Disabled)
+{
+	// No trace state is added to the containers
+	static_assert(sizeof(cc::fifo<int, 4, record_trace>) == sizeof(cc::fifo<int, 4>));
+	static_assert(sizeof(cc::buffer<int, 4, cc::usdt_trace>) == sizeof(cc::buffer<int, 4>));
+
+	// Probes are nops when not attached, or compiled out without <sys/sdt.h>
+	cc::fifo<int, 4, cc::usdt_trace> f;
+	f.push(1);
+	ASSERT_EQ(f.pop(), 1);
+}